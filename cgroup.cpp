@@ -0,0 +1,283 @@
+#include "header.h"
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/inotify.h>
+
+// cgroup v2 hierarchy collector. The tree is walked once, then every cgroup directory
+// is watched for subdirectories being created or removed, so a refresh only reads the
+// statistics files and never has to rediscover thousands of containers.
+
+static const uint32_t CGROUP_WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+static const double CGROUP_REWALK_INTERVAL = 10.0;   // only used when inotify ran out of watches
+
+// Find `key` at the start of a line of a flat-keyed cgroup file ("usage_usec 123")
+static bool findCgroupKey(const char* buf, size_t len, const char* key, uint64_t& value) {
+    size_t keyLen = strlen(key);
+    const char* end = buf + len;
+    for (const char* p = buf; p < end; ) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        if (static_cast<size_t>(lineEnd - p) > keyLen && memcmp(p, key, keyLen) == 0 && p[keyLen] == ' ') {
+            const char* number = p + keyLen;
+            value = static_cast<uint64_t>(parseStatField(number, lineEnd));
+            return true;
+        }
+        p = lineEnd + 1;
+    }
+    return false;
+}
+
+// Parse cpu.stat, present in every cgroup even without the cpu controller
+bool parseCgroupCPUStat(const char* buf, size_t len, CgroupStats& stats) {
+    return findCgroupKey(buf, len, "usage_usec", stats.cpuUsageUsec);
+}
+
+// Parse memory.stat
+bool parseCgroupMemoryStat(const char* buf, size_t len, CgroupStats& stats) {
+    bool anon = findCgroupKey(buf, len, "anon", stats.memoryAnon);
+    bool file = findCgroupKey(buf, len, "file", stats.memoryFile);
+    return anon || file;
+}
+
+// Parse io.stat, one line per device:
+//   8:0 rbytes=1459200 wbytes=314773504 rios=192 wios=353 dbytes=0 dios=0
+bool parseCgroupIOStat(const char* buf, size_t len, CgroupStats& stats) {
+    stats.ioReadBytes = 0;
+    stats.ioWriteBytes = 0;
+    const char* end = buf + len;
+    for (const char* p = buf; p < end; ) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* field = static_cast<const char*>(memmem(p, lineEnd - p, "rbytes=", 7));
+        if (field) {
+            field += 7;
+            stats.ioReadBytes += parseStatField(field, lineEnd);
+        }
+        field = static_cast<const char*>(memmem(p, lineEnd - p, "wbytes=", 7));
+        if (field) {
+            field += 7;
+            stats.ioWriteBytes += parseStatField(field, lineEnd);
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+// Read a statistics file of one cgroup relative to the open root, into `buf`
+static ssize_t readCgroupFile(int rootFd, const string& path, const char* file, char* buf, size_t size) {
+    char relative[PATH_MAX];
+    snprintf(relative, sizeof(relative), "%s%s%s", path.c_str(), path.empty() ? "" : "/", file);
+    int fd = openat(rootFd, relative, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;  // controller not enabled here, or the cgroup is gone
+    ssize_t len = read(fd, buf, size);
+    ::close(fd);
+    return len;
+}
+
+// '/' sorts before every other character, so "a/b" comes right after "a" and before "a-b"
+bool CgroupTree::PreOrder::operator()(const string& a, const string& b) const {
+    size_t n = min(a.size(), b.size());
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] == b[i]) continue;
+        if (a[i] == '/') return true;
+        if (b[i] == '/') return false;
+        return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]);
+    }
+    return a.size() < b.size();
+}
+
+CgroupTree::CgroupTree()
+    : rootFd(-1), inotifyFd(-1), watchesExhausted(false), lastRewalk(0.0) {
+}
+
+CgroupTree::~CgroupTree() {
+    close();
+}
+
+// Walk the whole hierarchy and start watching it
+bool CgroupTree::open() {
+    close();
+    root = getCgroupRoot();
+    if (root.empty()) return false;
+    rootFd = ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0) return false;
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    rewalk();
+    return true;
+}
+
+void CgroupTree::close() {
+    if (inotifyFd >= 0) ::close(inotifyFd);  // drops every watch with it
+    if (rootFd >= 0) ::close(rootFd);
+    inotifyFd = -1;
+    rootFd = -1;
+    watchesExhausted = false;
+    nodes.clear();
+    watches.clear();
+}
+
+// Add one cgroup and everything below it. The watch goes on before the directory is
+// listed, so a child created in between is reported by inotify rather than lost
+void CgroupTree::add(const string& path) {
+    string dir = path.empty() ? root : root + "/" + path;
+    auto inserted = nodes.emplace(path, Node{ -1, 0, 0, 0, 0.0, true });
+    Node& node = inserted.first->second;
+    node.seen = true;
+
+    if (node.watch < 0 && inotifyFd >= 0 && !watchesExhausted) {
+        node.watch = inotify_add_watch(inotifyFd, dir.c_str(), CGROUP_WATCH_MASK);
+        if (node.watch >= 0) {
+            watches[node.watch] = path;
+        } else if (errno == ENOSPC) {
+            watchesExhausted = true;   // fs.inotify.max_user_watches, rewalk periodically instead
+        }
+    }
+
+    DIR* cgroupDir = opendir(dir.c_str());
+    if (cgroupDir == nullptr) return;
+    struct dirent* entry;
+    while ((entry = readdir(cgroupDir)) != nullptr) {
+        if (entry->d_type != DT_DIR || entry->d_name[0] == '.') continue;
+        add(path.empty() ? string(entry->d_name) : path + "/" + entry->d_name);
+    }
+    closedir(cgroupDir);
+}
+
+// Forget a cgroup and everything below it
+void CgroupTree::remove(const string& path) {
+    auto it = nodes.lower_bound(path);
+    while (it != nodes.end() && it->first.compare(0, path.size(), path) == 0 &&
+           (it->first.size() == path.size() || it->first[path.size()] == '/' || path.empty())) {
+        if (it->second.watch >= 0) {
+            inotify_rm_watch(inotifyFd, it->second.watch);
+            watches.erase(it->second.watch);
+        }
+        it = nodes.erase(it);
+    }
+}
+
+// Walk the whole hierarchy again, keeping the rate history of cgroups that are still there
+void CgroupTree::rewalk() {
+    for (auto& node : nodes) node.second.seen = false;
+    add("");
+    for (auto it = nodes.begin(); it != nodes.end(); ) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            if (it->second.watch >= 0) watches.erase(it->second.watch);
+            it = nodes.erase(it);
+        }
+    }
+    lastRewalk = monotonicSeconds();
+}
+
+// Apply the pending inotify events, returns true if cgroups came or went
+bool CgroupTree::applyEvents() {
+    if (rootFd < 0) return false;
+    bool changed = false;
+    bool overflow = false;
+
+    if (inotifyFd >= 0) {
+        alignas(struct inotify_event) char buf[8192];
+        ssize_t len;
+        while ((len = read(inotifyFd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + len; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+                p += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                    continue;
+                }
+                auto watch = watches.find(event->wd);
+                if (watch == watches.end()) continue;
+                if (event->mask & IN_IGNORED) {
+                    // the directory itself was removed, its parent reports the IN_DELETE
+                    auto node = nodes.find(watch->second);
+                    if (node != nodes.end()) node->second.watch = -1;
+                    watches.erase(watch);
+                    continue;
+                }
+                if (!(event->mask & IN_ISDIR) || event->len == 0) continue;
+
+                const string& parent = watch->second;
+                string path = parent.empty() ? string(event->name) : parent + "/" + event->name;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    add(path);
+                } else {
+                    remove(path);
+                }
+                changed = true;
+            }
+        }
+    }
+
+    // missed events or too few watches: only a full walk can tell what changed
+    if (overflow || (watchesExhausted && monotonicSeconds() - lastRewalk >= CGROUP_REWALK_INTERVAL)) {
+        size_t before = nodes.size();
+        rewalk();
+        changed = changed || overflow || nodes.size() != before;
+    }
+    return changed;
+}
+
+// Read cpu.stat, memory.current, memory.stat and io.stat of every cgroup into `rows`,
+// in pre-order, and turn the counters into rates against the previous refresh
+void CgroupTree::refresh(vector<CgroupStats>& rows, double now) {
+    rows.resize(nodes.size());
+    vector<int> ancestors;   // indices of the rows whose subtree is still open
+    char buf[8192];
+    int index = 0;
+
+    for (auto& entry : nodes) {
+        const string& path = entry.first;
+        Node& node = entry.second;
+        CgroupStats& row = rows[index];
+
+        row.path = path;
+        size_t slash = path.rfind('/');
+        row.name = path.empty() ? "/" : (slash == string::npos ? path : path.substr(slash + 1));
+        row.depth = path.empty() ? 0 : 1 + static_cast<int>(count(path.begin(), path.end(), '/'));
+        while (!ancestors.empty() && rows[ancestors.back()].depth >= row.depth) {
+            rows[ancestors.back()].subtreeEnd = index;
+            ancestors.pop_back();
+        }
+        ancestors.push_back(index);
+
+        row.cpuUsageUsec = 0;
+        ssize_t len = readCgroupFile(rootFd, path, "cpu.stat", buf, sizeof(buf));
+        if (len > 0) parseCgroupCPUStat(buf, len, row);
+
+        len = readCgroupFile(rootFd, path, "memory.current", buf, sizeof(buf));
+        row.hasMemory = len > 0;
+        row.memoryCurrent = row.memoryAnon = row.memoryFile = 0;
+        if (len > 0) {
+            const char* p = buf;
+            row.memoryCurrent = static_cast<uint64_t>(parseStatField(p, buf + len));
+            len = readCgroupFile(rootFd, path, "memory.stat", buf, sizeof(buf));
+            if (len > 0) parseCgroupMemoryStat(buf, len, row);
+        }
+
+        len = readCgroupFile(rootFd, path, "io.stat", buf, sizeof(buf));
+        row.hasIO = len >= 0;
+        row.ioReadBytes = row.ioWriteBytes = 0;
+        if (len > 0) parseCgroupIOStat(buf, len, row);
+
+        // counters that went backwards belong to a cgroup recreated under the same name
+        double seconds = now - node.time;
+        bool haveRate = node.time > 0.0 && seconds > 0.0;
+        auto rate = [&](uint64_t value, uint64_t previous, double unit) {
+            return haveRate && value >= previous ? static_cast<float>((value - previous) / seconds / unit) : 0.0f;
+        };
+        row.cpuPercent = rate(row.cpuUsageUsec, node.cpuUsageUsec, 1e6) * 100.0f;
+        row.ioReadRate = rate(row.ioReadBytes, node.ioReadBytes, 1.0);
+        row.ioWriteRate = rate(row.ioWriteBytes, node.ioWriteBytes, 1.0);
+        node.cpuUsageUsec = row.cpuUsageUsec;
+        node.ioReadBytes = row.ioReadBytes;
+        node.ioWriteBytes = row.ioWriteBytes;
+        node.time = now;
+        index++;
+    }
+    for (int open : ancestors) rows[open].subtreeEnd = index;
+}
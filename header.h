@@ -32,6 +32,12 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <map>
+#include <unordered_set>
+#include <unordered_map>
+// regex queries in the process search
+#include <regex>
+// lock-free snapshot exchange between the sampler thread and the UI
+#include <atomic>
 
 using namespace std;
 
@@ -49,6 +55,41 @@ struct CPUStats
     long long int guestNice;
 };
 
+// Share of one interval spent in each state, in percent. As in /proc/stat, guest time
+// is also counted in user (and guestNice in nice); here it is taken out, so the fields
+// add up to 100
+struct CPUBreakdown
+{
+    float user;
+    float nice;
+    float system;
+    float idle;
+    float iowait;
+    float irq;
+    float softirq;
+    float steal;
+    float guest;
+    float guestNice;
+    float busy;         // everything but idle and iowait
+};
+
+// Aggregate breakdown of one CPU sampling interval, queued to the UI for the stacked graph
+struct CPUTimeSample
+{
+    double time;        // monotonicSeconds() when /proc/stat was read
+    CPUBreakdown breakdown;
+};
+
+// The aggregate and per-core breakdown over the last CPU sampling interval
+struct CPUSample
+{
+    uint64_t generation = 0;
+    double time = 0.0;              // monotonicSeconds() when /proc/stat was read
+    CPUBreakdown total = {};
+    vector<CPUBreakdown> cores;     // indexed by CPU number, all zero while a CPU is offline
+    vector<bool> online;
+};
+
 // processes `stat`
 struct Proc
 {
@@ -59,6 +100,23 @@ struct Proc
     long long int rss;
     long long int utime;
     long long int stime;
+    unsigned long long int startTime;
+    float cpuPercent;
+    uid_t uid;
+    bool hasIO;             // false when /proc/[pid]/io is not readable (another user's process)
+    float readRate;         // read_bytes per second, storage I/O rather than page cache hits
+    float writeRate;        // write_bytes per second
+    float syscrRate;        // read syscalls per second
+    float syscwRate;        // write syscalls per second
+};
+
+// processes `io`, cumulative since the process started
+struct ProcIO
+{
+    uint64_t readBytes;
+    uint64_t writeBytes;
+    uint64_t syscr;
+    uint64_t syscw;
 };
 
 struct IP4
@@ -105,22 +163,153 @@ struct TaskStats {
     int total;
 };
 
+// Fixed-capacity history of the most recent values. The capacity is a power of
+// two so the write position wraps with a mask, and pushing never moves data.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 128) { reset(capacity); }
+
+    // Drop every value and change the capacity, rounded up to a power of two
+    void reset(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        values.assign(size, T());
+        head = 0;
+        count = 0;
+    }
+    // Change the capacity, keeping the newest values that still fit
+    void resize(size_t capacity) {
+        RingBuffer<T> resized(capacity);
+        size_t keep = count < resized.capacity() ? count : resized.capacity();
+        for (size_t i = count - keep; i < count; i++) resized.push((*this)[i]);
+        *this = std::move(resized);
+    }
+    void push(const T& value) {
+        values[head] = value;
+        head = (head + 1) & (values.size() - 1);
+        if (count < values.size()) count++;
+    }
+    size_t size() const { return count; }
+    size_t capacity() const { return values.size(); }
+    bool empty() const { return count == 0; }
+    // 0 is the oldest value, size() - 1 the newest
+    const T& operator[](size_t i) const { return values[(head - count + i) & (values.size() - 1)]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    // Raw storage and the index of the oldest value, for ImGui::PlotLines(values, count, offset)
+    const T* data() const { return values.data(); }
+    int plotOffset() const { return count == values.size() ? static_cast<int>(head) : 0; }
+
+private:
+    vector<T> values;
+    size_t head;    // next write position
+    size_t count;
+};
+
 // system stats
+// Pressure stall information, from /proc/pressure/* or a cgroup's *.pressure files
+enum PressureResource {
+    PRESSURE_CPU,
+    PRESSURE_MEMORY,
+    PRESSURE_IO,
+    PRESSURE_COUNT
+};
+
+struct PressureLine {
+    float avg10;        // % of time stalled, kernel running averages
+    float avg60;
+    float avg300;
+    uint64_t total;     // microseconds stalled since boot
+    float rate;         // % of the last sampling interval stalled, from the change in `total`
+};
+
+struct PressureStats {
+    PressureLine some;  // at least one task stalled
+    PressureLine full;  // every non-idle task stalled at once
+    bool valid;         // false if the file is missing (no CONFIG_PSI, or no such cgroup)
+};
+
+// Facts that only change on rare events, read once and then refreshed on notification
+struct SystemFacts
+{
+    string osInfo;
+    string hostname;
+    string loggedInUser;
+    string cpuModel;
+};
+
 string CPUinfo();
 const char *getOsName();
 string getLoggedInUser();
 string getDetailedOSInfo();
 string getHostname();
-TaskStats getProcessStats();
+string getCgroupRoot();
+bool parsePressure(const char* buf, size_t len, PressureStats& stats);
+int openPressureFile(const string& dir, PressureResource resource, bool perCgroup);
+bool readPressure(int fd, PressureStats& stats);
+void computePressureRates(PressureStats& now, const PressureStats& prev, double seconds);
+int openPressureTrigger(PressureResource resource, uint64_t stallUs, uint64_t windowUs);
+void loadSystemFacts(SystemFacts& facts);
+int openSystemFactsWatch();
+bool refreshSystemFacts(SystemFacts& facts, int watchFd, double now);
+string getUserName(uid_t uid);
+TaskStats getProcessStats(const vector<Proc>& processes);
 string getCPUType();
+int getCPUCount();
+double monotonicSeconds();
 
 
 
 // For performance monitoring
+// Metrics the sampler streams to the System window, each at its own rate
+enum Metric {
+    METRIC_CPU,
+    METRIC_FAN,
+    METRIC_THERMAL,
+    METRIC_COUNT
+};
+
+struct MetricSample {
+    double time;    // monotonicSeconds() when the value was read
+    float value;
+};
+
+// Fan and temperature sensors, found once in /sys/class/thermal and /sys/class/hwmon
+enum SensorKind {
+    SENSOR_TEMPERATURE,
+    SENSOR_FAN
+};
+
+struct SensorReading {
+    SensorKind kind;
+    string label;       // e.g. "coretemp: Package id 0" or "x86_pkg_temp (thermal_zone1)"
+    float value;        // degrees Celsius or RPM
+    bool valid;         // false while the driver fails to read it
+};
+
+struct Sensor {
+    SensorReading reading;
+    int fd;             // kept open and re-read with pread
+    float scale;        // raw sysfs value to degrees Celsius or RPM
+};
+
+// Every sensor's latest value, published by the sampler whenever the fan or thermal metric is read
+struct SensorSample {
+    uint64_t generation = 0;
+    vector<SensorReading> sensors;
+    int graphSensor[2] = { -1, -1 };   // index in `sensors` feeding each graph, by SensorKind
+};
+
+// Longest graph history, e.g. 18 hours of 1 Hz samples
+const int PERFORMANCE_HISTORY_MAX = 65536;
+
 struct PerformanceData {
-    std::vector<float> values;
+    RingBuffer<float> values;
+    int historyLength;      // samples shown in the graph
     bool isPaused;
-    int fps;
+    int fps;                // samples per second, see setMetricRate()
+    double lastTime;        // MetricSample::time of the newest sample, 0 before the first one
     float yScale;
     float currentValue;
 };
@@ -128,17 +317,32 @@ struct PerformanceData {
 // Function declarations for performance monitoring
 void initPerformanceData(PerformanceData& data);
 void updatePerformanceData(PerformanceData& data, float newValue);
-float getCPUUsage();
-int getFanSpeed();
-float getCPUTemperature();
+void addPerformanceSample(PerformanceData& data, const MetricSample& sample);
+void setPerformanceHistory(PerformanceData& data, int length);
+float getPerformanceValue(void* data, int index);
+bool parseCPUStats(const char* buf, size_t len, CPUStats& total, vector<CPUStats>& cores, vector<bool>& online);
+bool readCPUStats(CPUStats& total, vector<CPUStats>& cores, vector<bool>& online);
+void computeCPUBreakdown(const CPUStats& now, const CPUStats& prev, CPUBreakdown& out);
+void discoverSensors(vector<Sensor>& sensors);
+void readSensors(vector<Sensor>& sensors, SensorKind kind);
+void closeSensors(vector<Sensor>& sensors);
+int choosePrimarySensor(const vector<Sensor>& sensors, SensorKind kind);
 void performanceWindow(const char *id, ImVec2 size, ImVec2 position);
 
 
 // network
 // Network interface information structure
+// Every address of one interface
+struct InterfaceAddresses {
+    vector<string> ipv4;
+    vector<string> ipv6;
+};
+typedef unordered_map<string, InterfaceAddresses> NetworkAddressMap;
+
 struct NetworkStats {
     string interface;
-    string ipv4;
+    string ipv4;                    // first IPv4 address, empty if none
+    InterfaceAddresses addresses;
     uint64_t rx_bytes;
     uint64_t rx_packets;
     uint64_t rx_errs;
@@ -155,21 +359,130 @@ struct NetworkStats {
     uint64_t tx_colls;
     uint64_t tx_carrier;
     uint64_t tx_compressed;
+
+    double timestamp;               // monotonicSeconds() when the counters were read
+    int speedMbps;                  // link speed from sysfs, -1 when unknown or down
+    // per-second rates since the previous sample, 0 on the first one
+    float rx_bytes_rate;
+    float tx_bytes_rate;
+    float rx_packets_rate;
+    float tx_packets_rate;
+};
+
+// Rolling rate history of one interface, kept by the Network window
+struct InterfaceHistory {
+    RingBuffer<float> rx_bytes_rate;
+    RingBuffer<float> tx_bytes_rate;
+    bool seen;
 };
 
 // Network functions
 string formatBytes(uint64_t bytes);
-vector<pair<string, string>> getNetworkInterfaces();
-NetworkStats getNetworkStats(const string& interface);
+NetworkAddressMap getNetworkAddresses();
+NetworkStats getNetworkStats(const string& interface, const NetworkAddressMap& addresses);
+bool parseNetDev(const char* buf, size_t len, vector<NetworkStats>& stats);
+void setNetlinkEnabled(bool enabled);
+int openLinkEventSocket();
+bool drainLinkEvents(int fd);
 vector<NetworkStats> getAllNetworkStats();
+int getLinkSpeed(const string& interface);
+void computeNetworkRates(vector<NetworkStats>& current, const vector<NetworkStats>& previous);
 
 // memory and processes
 
 // Memory usage structure
+// Every /proc/meminfo field, in kB except the HugePages_* page counts.
+// Fields the running kernel doesn't print stay 0
+struct ProcMemInfo {
+    uint64_t memTotal;
+    uint64_t memFree;
+    uint64_t memAvailable;
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t swapCached;
+
+    uint64_t active;
+    uint64_t inactive;
+    uint64_t activeAnon;
+    uint64_t inactiveAnon;
+    uint64_t activeFile;
+    uint64_t inactiveFile;
+    uint64_t unevictable;
+    uint64_t mlocked;
+
+    uint64_t swapTotal;
+    uint64_t swapFree;
+    uint64_t zswap;
+    uint64_t zswapped;
+
+    uint64_t dirty;
+    uint64_t writeback;
+    uint64_t anonPages;
+    uint64_t mapped;
+    uint64_t shmem;
+
+    uint64_t kReclaimable;
+    uint64_t slab;
+    uint64_t sReclaimable;
+    uint64_t sUnreclaim;
+
+    uint64_t kernelStack;
+    uint64_t pageTables;
+    uint64_t secPageTables;
+    uint64_t nfsUnstable;
+    uint64_t bounce;
+    uint64_t writebackTmp;
+
+    uint64_t commitLimit;
+    uint64_t committedAS;
+
+    uint64_t vmallocTotal;
+    uint64_t vmallocUsed;
+    uint64_t vmallocChunk;
+    uint64_t percpu;
+    uint64_t hardwareCorrupted;
+
+    uint64_t anonHugePages;
+    uint64_t shmemHugePages;
+    uint64_t shmemPmdMapped;
+    uint64_t fileHugePages;
+    uint64_t filePmdMapped;
+
+    uint64_t cmaTotal;
+    uint64_t cmaFree;
+    uint64_t balloon;
+    uint64_t unaccepted;
+
+    uint64_t hugePagesTotal;
+    uint64_t hugePagesFree;
+    uint64_t hugePagesRsvd;
+    uint64_t hugePagesSurp;
+    uint64_t hugepageSize;
+    uint64_t hugetlb;
+
+    uint64_t directMap4k;
+    uint64_t directMap2M;
+    uint64_t directMap4M;
+    uint64_t directMap1G;
+};
+
+// Memory breakdown in bytes, from /proc/meminfo
 struct MemoryInfo {
     uint64_t totalRam;
-    uint64_t usedRam;
-    uint64_t freeRam;
+    uint64_t usedRam;           // totalRam - availableRam: what can't be reclaimed without swapping
+    uint64_t freeRam;           // MemFree: not used for anything, not even cache
+    uint64_t availableRam;      // MemAvailable: free plus what the kernel can reclaim
+    uint64_t buffers;
+    uint64_t cached;            // page cache, including shmem
+    uint64_t sReclaimable;      // reclaimable part of slab
+    uint64_t shmem;             // tmpfs and shared memory, cached but not reclaimable
+    uint64_t dirty;             // page cache waiting to be written back
+    uint64_t writeback;         // page cache being written back
+    uint64_t anonPages;
+    uint64_t mapped;
+    uint64_t slab;
+    uint64_t hugePagesTotal;    // HugePages_Total * Hugepagesize
+    uint64_t hugePagesFree;
     uint64_t totalSwap;
     uint64_t usedSwap;
     uint64_t freeSwap;
@@ -184,15 +497,309 @@ struct DiskInfo {
 };
 
 // Memory functions
-MemoryInfo getMemoryInfo();
-MemoryInfo getMemoryInfoFromProc();  // Alternative method using /proc/meminfo
+MemoryInfo getMemoryInfoFromProc();
+bool parseMemInfo(const char* buf, size_t len, ProcMemInfo& info);
+bool readMemInfo(ProcMemInfo& info);
 vector<DiskInfo> getDiskInfo();
 string formatBytes(uint64_t bytes);
 float getMemoryUsagePercentage(const MemoryInfo& info);
 float getMemoryUsagePercentageFromProc(const MemoryInfo& info);  // Alternative calculation method
 float getSwapUsagePercentage(const MemoryInfo& info);
 float getDiskUsagePercentage(const DiskInfo& disk);
-vector<Proc> getProcessList();
-float calculateCPUPercentage(const Proc& proc);
+long long int parseStatField(const char*& p, const char* end);
+bool parseProcStat(const char* buf, size_t len, Proc& proc);
+bool parseProcIO(const char* buf, size_t len, ProcIO& io);
+void getProcessList(vector<Proc>& processes);
+void applyProcessDiff(vector<Proc>& rows, const vector<Proc>& latest);
+
+// Text of one Processes table row, formatted once per scan instead of every frame
+struct ProcRowText {
+    char pid[16];
+    char cpu[16];          // 100% is one core
+    char cpuAllCores[16];  // 100% is every core
+    char memory[16];
+    char readRate[16];     // "-" when the process's I/O is not readable
+    char writeRate[16];
+    char syscrRate[16];
+    char syscwRate[16];
+};
+void formatProcessRows(const vector<Proc>& processes, const MemoryInfo& memInfo, int cpuCount,
+                       vector<ProcRowText>& rows);
+
+// Processes table columns, also used as sort keys
+enum ProcColumn {
+    PROC_COLUMN_PID,
+    PROC_COLUMN_NAME,
+    PROC_COLUMN_STATE,
+    PROC_COLUMN_CPU,
+    PROC_COLUMN_MEMORY,
+    PROC_COLUMN_READ,
+    PROC_COLUMN_WRITE,
+    PROC_COLUMN_SYSCR,
+    PROC_COLUMN_SYSCW
+};
+size_t sortProcessRows(vector<int>& rows, const vector<Proc>& processes, int column, bool descending,
+                       size_t sortedCount, size_t wantCount);
+
+// What we remember about a PID between two scans
+struct ProcSlot {
+    int pid;                          // 0 marks an empty slot
+    unsigned long long int startTime; // tells a reused PID apart from the old process
+    long long int prevUtime;
+    long long int prevStime;
+    uint64_t generation;              // last scan that saw this PID
+    string name;                      // comm when `cmdline` and `uid` were read, re-read after an exec
+    string cmdline;                   // lowercased, arguments separated by spaces
+    uid_t uid;
+    float cpuPercent;                 // since the previous scan
+    bool ioReadable;                  // false once /proc/[pid]/io was refused, retried after an exec
+    bool hasIO;                       // `io` was read by the current scan
+    ProcIO io;
+    float readRate;                   // since the previous scan, like `cpuPercent`
+    float writeRate;
+    float syscrRate;
+    float syscwRate;
+};
+
+// Persistent PID -> ProcSlot table with open addressing and linear probing.
+// Every scan stamps the PIDs it sees, endScan() evicts the rest, so the table
+// only ever holds live processes no matter how many PIDs churn through it.
+class ProcessTable {
+public:
+    ProcessTable();
+    ~ProcessTable();
+    void beginScan(double now);       // monotonic seconds, see monotonicSeconds()
+    const ProcSlot& update(const Proc& proc);
+    void endScan();
+    size_t size() const { return count; }
+
+private:
+    size_t home(int pid) const;
+    size_t find(int pid) const;
+    void grow();
+    void erase(size_t index);
+
+    vector<ProcSlot> slots;   // capacity is always a power of two
+    size_t count;
+    int shift;                // 64 - log2(capacity)
+    uint64_t generation;
+    double scanTime;
+    double lastScanTime;
+    long ticksPerSecond;      // sysconf(_SC_CLK_TCK), utime/stime are counted in these
+    int procFd;               // /proc, each PID's files are opened relative to it
+};
+
+// Lowercased text the process search matches against, built once per scan
+struct ProcSearchText {
+    string name;
+    string cmdline;
+    string user;
+};
+
+// A parsed search box query: plain words must all appear in the name, PID or
+// command line; `user:` and `state:` narrow by owner and state; `re:` is a regex
+struct ProcQuery {
+    vector<string> words;
+    string user;
+    string state;
+    bool hasRegex = false;
+    bool regexValid = true;
+    regex pattern;
+};
+void buildProcessSearch(const ProcSlot& slot, ProcSearchText& search);
+void parseProcQuery(const char* input, ProcQuery& query);
+bool narrowsProcQuery(const ProcQuery& previous, const ProcQuery& next);
+bool matchProcess(const ProcQuery& query, const Proc& proc, const ProcRowText& text,
+                  const ProcSearchText& search);
+
+// cgroups
+
+// One cgroup v2 directory. cgroup v2 statistics are hierarchical, so every row already
+// includes everything below it: a container's slice shows the whole container
+struct CgroupStats {
+    string path;                // relative to getCgroupRoot(), "" for the root
+    string name;                // last path component, "/" for the root
+    int depth;                  // 0 for the root
+    int subtreeEnd;             // index one past the last descendant in the pre-order list
+    uint64_t cpuUsageUsec;      // cpu.stat usage_usec
+    float cpuPercent;           // 100% is one core
+    bool hasMemory;             // memory controller enabled for this cgroup
+    uint64_t memoryCurrent;
+    uint64_t memoryAnon;        // memory.stat anon
+    uint64_t memoryFile;        // memory.stat file (page cache)
+    bool hasIO;                 // io controller enabled for this cgroup
+    uint64_t ioReadBytes;       // io.stat rbytes, summed over devices
+    uint64_t ioWriteBytes;
+    float ioReadRate;           // bytes/s
+    float ioWriteRate;
+};
+
+bool parseCgroupCPUStat(const char* buf, size_t len, CgroupStats& stats);
+bool parseCgroupMemoryStat(const char* buf, size_t len, CgroupStats& stats);
+bool parseCgroupIOStat(const char* buf, size_t len, CgroupStats& stats);
+
+// The cgroup hierarchy, walked once and then kept up to date from inotify create and
+// delete events on every cgroup directory, instead of being rewalked on each refresh.
+// Falls back to periodic rewalks if inotify runs out of watches
+class CgroupTree {
+public:
+    CgroupTree();
+    ~CgroupTree();
+    bool open();                                    // false without a cgroup v2 hierarchy
+    void close();
+    bool applyEvents();                             // true if cgroups came or went
+    void refresh(vector<CgroupStats>& rows, double now);   // pre-order, siblings sorted by name
+
+private:
+    // orders paths so every cgroup comes right before its descendants
+    struct PreOrder {
+        bool operator()(const string& a, const string& b) const;
+    };
+    struct Node {
+        int watch;                  // inotify watch descriptor, -1 if none
+        uint64_t cpuUsageUsec;      // previous refresh, for rates
+        uint64_t ioReadBytes;
+        uint64_t ioWriteBytes;
+        double time;                // 0 until the first refresh
+        bool seen;                  // still present, see rewalk()
+    };
+
+    void add(const string& path);   // adds `path` and walks everything below it
+    void remove(const string& path);
+    void rewalk();
+
+    string root;
+    int rootFd;
+    int inotifyFd;
+    bool watchesExhausted;
+    double lastRewalk;
+    map<string, Node, PreOrder> nodes;
+    unordered_map<int, string> watches;             // watch descriptor -> path
+};
+
+// sampler
+
+// Lock-free triple buffer for one writer thread and one reader thread.
+// The writer fills writeBuffer() and publishes it, the reader picks up the newest
+// published value with update() and reads it until the next update().
+// Neither side ever blocks: the third buffer is always free for the writer.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : backIndex(0), middle(1), frontIndex(2) {}
+
+    // writer side
+    T& writeBuffer() { return buffers[backIndex].value; }
+    void publish() {
+        backIndex = middle.exchange(backIndex | DIRTY, memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // reader side, returns true when a newer value was picked up
+    bool update() {
+        if (!(middle.load(memory_order_relaxed) & DIRTY)) return false;
+        frontIndex = middle.exchange(frontIndex, memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& read() const { return buffers[frontIndex].value; }
+
+private:
+    static const int INDEX_MASK = 0x3;
+    static const int DIRTY = 0x4;
+
+    // keep each buffer and the shared index on their own cache line
+    struct alignas(64) Slot { T value; };
+    Slot buffers[3];
+    int backIndex;                    // only touched by the writer
+    alignas(64) atomic<int> middle;   // index of the last published buffer, plus DIRTY when unread
+    alignas(64) int frontIndex;       // only touched by the reader
+};
+
+// Lock-free bounded queue for one producer thread and one consumer thread.
+// push() fails instead of blocking when the consumer falls behind by a full queue.
+template <typename T>
+class SampleQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit SampleQueue(size_t capacity) : head(0), tail(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        values.resize(size);
+    }
+
+    // producer side
+    bool push(const T& value) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t - head.load(memory_order_acquire) == values.size()) return false;
+        values[t & (values.size() - 1)] = value;
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool pop(T& value) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h == tail.load(memory_order_acquire)) return false;
+        value = values[h & (values.size() - 1)];
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+private:
+    vector<T> values;
+    alignas(64) atomic<size_t> head;   // next value to pop, only written by the consumer
+    alignas(64) atomic<size_t> tail;   // next slot to push, only written by the producer
+};
+
+// Everything the windows display, collected off the render thread
+struct SystemSnapshot {
+    uint64_t generation = 0;
+
+    // system
+    SystemFacts facts;
+
+    // memory and processes
+    double memoryTime = 0.0;          // monotonicSeconds() of the last memory refresh
+    MemoryInfo memInfo = {};
+    vector<DiskInfo> diskInfo;
+    uint64_t processGeneration = 0;   // bumped by every /proc walk
+    double processTime = 0.0;         // monotonicSeconds() when that walk started
+    int cpuCount = 1;
+    vector<Proc> processes;           // stable order, see applyProcessDiff()
+    vector<ProcRowText> processText;  // same order as `processes`
+    vector<ProcSearchText> processSearch;  // same order as `processes`
+    TaskStats taskStats = {};          // counted from `processes`
+
+    // pressure
+    double pressureTime = 0.0;        // monotonicSeconds() of the last pressure refresh
+    double pressureTickTime = 0.0;    // pressureTime of the last periodic refresh, trigger wakeups leave it alone
+    PressureStats pressure[PRESSURE_COUNT] = {};        // system wide
+    string cgroupRoot;                // getCgroupRoot(), resolved once by the sampler, empty without cgroup v2
+    string pressureCgroup;            // cgroup of `cgroupPressure`, relative to `cgroupRoot`, empty for none
+    PressureStats cgroupPressure[PRESSURE_COUNT] = {};
+    bool pressureTriggers = false;    // whether PSI triggers wake the sampler
+    uint64_t pressureEvents = 0;      // trigger wakeups so far
+
+    // cgroups
+    uint64_t cgroupGeneration = 0;    // bumped by every cgroup refresh
+    vector<CgroupStats> cgroups;      // pre-order, see CgroupTree
+
+    // network
+    double networkTime = 0.0;         // monotonicSeconds() of the last network refresh
+    vector<NetworkStats> networkStats;
+};
+
+// Sampler functions
+void startSampler();
+void stopSampler();
+void setProcessRefreshInterval(int ms);
+void setPressureCgroup(const string& path);
+void setMetricRate(Metric metric, int hz);
+bool popMetricSample(Metric metric, MetricSample& sample);
+bool popCPUTimeSample(CPUTimeSample& sample);
+bool updateSnapshot();
+const SystemSnapshot& getLatestSnapshot();
+const CPUSample& getLatestCPUSample();
+const SensorSample& getLatestSensorSample();
+void setGraphSensor(SensorKind kind, int index);
 
 #endif
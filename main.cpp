@@ -2,6 +2,7 @@
 #include <SDL2/SDL.h>
 #include <algorithm>  // for std::find
 #include <string>    // for std::to_string
+#include <cstring>   // for strstr in the process search
 
 /*
 NOTE : You are free to change the code as you wish, the main objective is to make the
@@ -43,6 +44,276 @@ using namespace gl;
 #include IMGUI_IMPL_OPENGL_LOADER_CUSTOM
 #endif
 
+// CPU states of the stacked breakdown graph, bottom to top; idle is the space left above
+struct CPUTimeSeries
+{
+    const char* name;
+    float CPUBreakdown::*field;
+    ImU32 color;
+};
+static const CPUTimeSeries cpuTimeSeries[] = {
+    { "user",       &CPUBreakdown::user,      IM_COL32( 70, 130, 230, 255) },
+    { "nice",       &CPUBreakdown::nice,      IM_COL32( 90, 200, 220, 255) },
+    { "system",     &CPUBreakdown::system,    IM_COL32(230,  90,  70, 255) },
+    { "iowait",     &CPUBreakdown::iowait,    IM_COL32(240, 190,  40, 255) },
+    { "irq",        &CPUBreakdown::irq,       IM_COL32(170,  90, 210, 255) },
+    { "softirq",    &CPUBreakdown::softirq,   IM_COL32(210, 130, 230, 255) },
+    { "steal",      &CPUBreakdown::steal,     IM_COL32(250, 120, 160, 255) },
+    { "guest",      &CPUBreakdown::guest,     IM_COL32( 80, 190,  90, 255) },
+    { "guest nice", &CPUBreakdown::guestNice, IM_COL32(150, 220, 120, 255) },
+};
+static const int CPU_TIME_SERIES = sizeof(cpuTimeSeries) / sizeof(cpuTimeSeries[0]);
+
+// stackedPlot, draw `series` as stacked bands from 0 to `scaleMax`, sampling at most one
+// point every two pixels so the cost does not grow with the history length
+void stackedPlot(const char *id, PerformanceData *series, int count, float scaleMax, ImVec2 size)
+{
+    static vector<float> lower, upper;
+    int length = series[0].historyLength;
+    int columns = max(2, min(length, static_cast<int>(size.x / 2.0f)));
+    lower.assign(columns, 0.0f);
+    upper.resize(columns);
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::InvisibleButton(id, size);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+    float xStep = size.x / (columns - 1);
+    auto toY = [&](float value) { return origin.y + size.y * (1.0f - min(value / scaleMax, 1.0f)); };
+    auto toIndex = [&](int column) { return static_cast<int>(static_cast<long long>(column) * (length - 1) / (columns - 1)); };
+    for (int k = 0; k < count; k++) {
+        for (int c = 0; c < columns; c++) {
+            upper[c] = lower[c] + getPerformanceValue(&series[k], toIndex(c));
+        }
+        for (int c = 0; c + 1 < columns; c++) {
+            if (upper[c] == lower[c] && upper[c + 1] == lower[c + 1]) continue;
+            float x0 = origin.x + c * xStep, x1 = x0 + xStep;
+            drawList->AddQuadFilled(ImVec2(x0, toY(upper[c])), ImVec2(x1, toY(upper[c + 1])),
+                                    ImVec2(x1, toY(lower[c + 1])), ImVec2(x0, toY(lower[c])), cpuTimeSeries[k].color);
+        }
+        lower.swap(upper);
+    }
+
+    if (ImGui::IsItemHovered()) {
+        float t = (ImGui::GetIO().MousePos.x - origin.x) / size.x;
+        int index = static_cast<int>(t * (length - 1) + 0.5f);
+        ImGui::BeginTooltip();
+        for (int k = 0; k < count; k++) {
+            ImGui::TextColored(ImColor(cpuTimeSeries[k].color), "%-10s %5.1f%%", cpuTimeSeries[k].name,
+                               getPerformanceValue(&series[k], index));
+        }
+        ImGui::EndTooltip();
+    }
+}
+
+// sensorTable, list every sensor of one kind; clicking a row graphs that sensor.
+// Returns true when the graphed sensor changed
+bool sensorTable(const char *id, const SensorSample& sample, SensorKind kind, const char *format)
+{
+    bool changed = false;
+    if (ImGui::BeginTable(id, 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Sensor");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < sample.sensors.size(); i++) {
+            const SensorReading& sensor = sample.sensors[i];
+            if (sensor.kind != kind) continue;
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            bool graphed = sample.graphSensor[kind] == static_cast<int>(i);
+            if (ImGui::Selectable(sensor.label.c_str(), graphed, ImGuiSelectableFlags_SpanAllColumns) && !graphed) {
+                setGraphSensor(kind, static_cast<int>(i));
+                changed = true;
+            }
+            ImGui::TableSetColumnIndex(1);
+            if (sensor.valid) {
+                ImGui::Text(format, sensor.value);
+            } else {
+                ImGui::TextDisabled("n/a");
+            }
+        }
+        ImGui::EndTable();
+    }
+    return changed;
+}
+
+// pressureTable, one row per resource with the kernel averages and the last interval
+void pressureTable(const char *id, const PressureStats *pressure)
+{
+    static const char* names[PRESSURE_COUNT] = { "CPU", "Memory", "I/O" };
+    if (ImGui::BeginTable(id, 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Resource");
+        ImGui::TableSetupColumn("some 10s");
+        ImGui::TableSetupColumn("some 60s");
+        ImGui::TableSetupColumn("some 300s");
+        ImGui::TableSetupColumn("some now");
+        ImGui::TableSetupColumn("full 10s");
+        ImGui::TableSetupColumn("full now");
+        ImGui::TableHeadersRow();
+        for (int r = 0; r < PRESSURE_COUNT; r++) {
+            const PressureStats& stats = pressure[r];
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%s", names[r]);
+            if (!stats.valid) {
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextDisabled("n/a");
+                continue;
+            }
+            float values[] = { stats.some.avg10, stats.some.avg60, stats.some.avg300, stats.some.rate,
+                               stats.full.avg10, stats.full.rate };
+            for (int c = 0; c < 6; c++) {
+                ImGui::TableSetColumnIndex(c + 1);
+                ImGui::Text("%.2f%%", values[c]);
+            }
+        }
+        ImGui::EndTable();
+    }
+}
+
+// pressureTab, show how much time tasks spent stalled on CPU, memory and I/O (PSI),
+// system wide and for one chosen cgroup, with the history of the last ten minutes
+void pressureTab(const SystemSnapshot& snapshot)
+{
+    static const char* names[PRESSURE_COUNT] = { "CPU", "Memory", "I/O" };
+    static vector<RingBuffer<float>> history(PRESSURE_COUNT, RingBuffer<float>(600));
+    static vector<RingBuffer<float>> cgroupHistory(PRESSURE_COUNT, RingBuffer<float>(600));
+    // totals at the previous periodic refresh: one point per second, taken over the whole
+    // second, so trigger wakeups in between neither add points nor hide their stall
+    static PressureStats tickPressure[PRESSURE_COUNT] = {};
+    static PressureStats tickCgroupPressure[PRESSURE_COUNT] = {};
+    static double lastTickTime = 0.0;
+    static string historyCgroup;
+    static char cgroupBuffer[256] = "";
+
+    if (snapshot.pressureCgroup != historyCgroup) {
+        historyCgroup = snapshot.pressureCgroup;
+        for (RingBuffer<float>& values : cgroupHistory) values.reset(values.capacity());
+        for (PressureStats& stats : tickCgroupPressure) stats = PressureStats();
+    }
+    if (snapshot.pressureTickTime != lastTickTime) {
+        double seconds = snapshot.pressureTickTime - lastTickTime;
+        lastTickTime = snapshot.pressureTickTime;
+        for (int r = 0; r < PRESSURE_COUNT; r++) {
+            PressureStats stats = snapshot.pressure[r];
+            computePressureRates(stats, tickPressure[r], seconds);
+            history[r].push(stats.some.rate);
+            tickPressure[r] = stats;
+
+            stats = snapshot.cgroupPressure[r];
+            if (!stats.valid) continue;
+            computePressureRates(stats, tickCgroupPressure[r], seconds);
+            cgroupHistory[r].push(stats.some.rate);
+            tickCgroupPressure[r] = stats;
+        }
+    }
+
+    if (!snapshot.pressure[PRESSURE_CPU].valid) {
+        ImGui::TextDisabled("Pressure stall information is not available (needs CONFIG_PSI, and psi=1 on some kernels)");
+        return;
+    }
+    if (snapshot.pressureTriggers) {
+        ImGui::Text("Stall triggers: on, %llu events", static_cast<unsigned long long>(snapshot.pressureEvents));
+    } else {
+        ImGui::Text("Stall triggers: unavailable, refreshed every second");
+    }
+
+    ImGui::Text("System");
+    pressureTable("##SystemPressure", snapshot.pressure);
+
+    ImGui::SetNextItemWidth(250.0f);
+    if (ImGui::InputText("cgroup", cgroupBuffer, sizeof(cgroupBuffer), ImGuiInputTextFlags_EnterReturnsTrue)) {
+        setPressureCgroup(cgroupBuffer);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Path under %s, e.g. system.slice/docker.service\nPress Enter to apply, clear to hide",
+                          snapshot.cgroupRoot.empty() ? "the cgroup v2 mount" : snapshot.cgroupRoot.c_str());
+    }
+    if (!snapshot.pressureCgroup.empty()) {
+        pressureTable("##CgroupPressure", snapshot.cgroupPressure);
+    }
+
+    // "some" over each refresh interval: at least one task was waiting
+    float width = ImGui::GetContentRegionAvail().x;
+    for (int r = 0; r < PRESSURE_COUNT; r++) {
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%s some %.1f%%  full %.1f%%", names[r],
+                 snapshot.pressure[r].some.rate, snapshot.pressure[r].full.rate);
+        ImGui::PushID(r);
+        ImGui::PlotLines("##pressure", history[r].data(), static_cast<int>(history[r].size()), history[r].plotOffset(),
+                         overlay, 0.0f, 100.0f, ImVec2(width, 50));
+        if (!snapshot.pressureCgroup.empty()) {
+            snprintf(overlay, sizeof(overlay), "%s some (cgroup) %.1f%%", names[r], snapshot.cgroupPressure[r].some.rate);
+            ImGui::PlotLines("##cgroupPressure", cgroupHistory[r].data(), static_cast<int>(cgroupHistory[r].size()),
+                             cgroupHistory[r].plotOffset(), overlay, 0.0f, 100.0f, ImVec2(width, 50));
+        }
+        ImGui::PopID();
+    }
+}
+
+// cpuHeatmap, draw one cell per logical CPU colored by how busy it was over the last
+// sample. Cells go straight to the draw list, so 256+ CPUs cost one item, not one widget each
+void cpuHeatmap(const CPUSample& sample)
+{
+    static vector<RingBuffer<float>> coreHistory;   // busy % per core, for the hover sparkline
+    static uint64_t lastGeneration = 0;
+    if (sample.generation != lastGeneration) {
+        lastGeneration = sample.generation;
+        if (coreHistory.size() != sample.cores.size()) {
+            coreHistory.assign(sample.cores.size(), RingBuffer<float>(128));
+        }
+        for (size_t i = 0; i < sample.cores.size(); i++) {
+            coreHistory[i].push(sample.cores[i].busy);
+        }
+    }
+
+    const int count = static_cast<int>(sample.cores.size());
+    if (count == 0) return;
+    const float cell = 18.0f;
+    const float spacing = 2.0f;
+    int columns = max(1, static_cast<int>((ImGui::GetContentRegionAvail().x + spacing) / (cell + spacing)));
+    int rows = (count + columns - 1) / columns;
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Dummy(ImVec2(columns * (cell + spacing) - spacing, rows * (cell + spacing) - spacing));
+    bool hovered = ImGui::IsItemHovered();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    for (int i = 0; i < count; i++) {
+        ImVec2 cellMin(origin.x + (i % columns) * (cell + spacing), origin.y + (i / columns) * (cell + spacing));
+        ImVec2 cellMax(cellMin.x + cell, cellMin.y + cell);
+        if (!ImGui::IsRectVisible(cellMin, cellMax)) continue;
+
+        // green when idle through red when saturated, grey while offline
+        ImU32 color = IM_COL32(60, 60, 60, 255);
+        if (sample.online[i]) {
+            float busy = sample.cores[i].busy / 100.0f;
+            color = ImColor::HSV(0.33f * (1.0f - busy), 0.85f, 0.35f + 0.65f * busy);
+        }
+        drawList->AddRectFilled(cellMin, cellMax, color, 2.0f);
+
+        if (hovered && mouse.x >= cellMin.x && mouse.x < cellMax.x && mouse.y >= cellMin.y && mouse.y < cellMax.y) {
+            drawList->AddRect(cellMin, cellMax, IM_COL32(255, 255, 255, 255), 2.0f);
+            const CPUBreakdown& core = sample.cores[i];
+            ImGui::BeginTooltip();
+            if (!sample.online[i]) {
+                ImGui::Text("CPU %d: offline", i);
+            } else {
+                ImGui::Text("CPU %d: %.1f%% busy", i, core.busy);
+                ImGui::Text("user %.1f%%  nice %.1f%%  system %.1f%%", core.user, core.nice, core.system);
+                ImGui::Text("iowait %.1f%%  irq %.1f%%  softirq %.1f%%", core.iowait, core.irq, core.softirq);
+                ImGui::Text("steal %.1f%%  guest %.1f%%", core.steal, core.guest + core.guestNice);
+                const RingBuffer<float>& history = coreHistory[i];
+                ImGui::PlotLines("##core", history.data(), static_cast<int>(history.size()), history.plotOffset(),
+                                 NULL, 0.0f, 100.0f, ImVec2(200, 40));
+            }
+            ImGui::EndTooltip();
+        }
+    }
+}
+
 // systemWindow, display information for the system monitorization
 void systemWindow(const char *id, ImVec2 size, ImVec2 position)
 {
@@ -50,8 +321,9 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
     ImGui::SetWindowSize(id, size);
     ImGui::SetWindowPos(id, position);
 
-    // Get task statistics first
-    TaskStats stats = getProcessStats();
+    // Everything below reads the sampler's last snapshot, never /proc directly
+    const SystemSnapshot& snapshot = getLatestSnapshot();
+    const TaskStats& stats = snapshot.taskStats;
     
     ImGui::Separator();
 
@@ -65,36 +337,56 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
     // Display system information
     ImGui::Text("Operating System:");
     ImGui::SameLine();
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", getDetailedOSInfo().c_str());
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", snapshot.facts.osInfo.c_str());
     
     // Hostname
     ImGui::Text("Computer Name:");
     ImGui::SameLine();
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", getHostname().c_str());
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", snapshot.facts.hostname.c_str());
     
     ImGui::Text("Logged in User:");
     ImGui::SameLine();
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", getLoggedInUser().c_str());
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", snapshot.facts.loggedInUser.c_str());
     
     ImGui::Text("CPU Model:");
     ImGui::SameLine();
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", CPUinfo().c_str());
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", snapshot.facts.cpuModel.c_str());
 
     // Performance Monitoring Tabs
     static PerformanceData cpuData, fanData, thermalData;
+    static PerformanceData cpuTimes[CPU_TIME_SERIES];   // one per cpuTimeSeries entry
     static bool initialized = false;
 
     if (!initialized) {
         initPerformanceData(cpuData);
         initPerformanceData(fanData);
         initPerformanceData(thermalData);
+        for (PerformanceData& data : cpuTimes) initPerformanceData(data);
+        setMetricRate(METRIC_CPU, cpuData.fps);
+        setMetricRate(METRIC_FAN, fanData.fps);
+        setMetricRate(METRIC_THERMAL, thermalData.fps);
         initialized = true;
     }
 
-    // Update data
-    updatePerformanceData(cpuData, getCPUUsage());
-    updatePerformanceData(fanData, getFanSpeed());
-    updatePerformanceData(thermalData, getCPUTemperature());
+    // Take every sample the sampler read since the last frame, at the rate set by
+    // each FPS slider, whatever the frame rate is
+    MetricSample sample;
+    while (popMetricSample(METRIC_CPU, sample)) addPerformanceSample(cpuData, sample);
+    while (popMetricSample(METRIC_FAN, sample)) addPerformanceSample(fanData, sample);
+    while (popMetricSample(METRIC_THERMAL, sample)) addPerformanceSample(thermalData, sample);
+
+    // the breakdown comes from the same /proc/stat reads as the CPU graph, so it follows
+    // that graph's rate, pause and history settings
+    CPUTimeSample timeSample;
+    while (popCPUTimeSample(timeSample)) {
+        for (int k = 0; k < CPU_TIME_SERIES; k++) {
+            PerformanceData& data = cpuTimes[k];
+            data.fps = cpuData.fps;
+            data.isPaused = cpuData.isPaused;
+            if (data.historyLength != cpuData.historyLength) setPerformanceHistory(data, cpuData.historyLength);
+            addPerformanceSample(data, { timeSample.time, timeSample.breakdown.*cpuTimeSeries[k].field });
+        }
+    }
 
     ImGui::Separator();
     if (ImGui::BeginTabBar("PerformanceTabs")) {
@@ -103,12 +395,35 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
             ImGui::Text("CPU Usage: %.1f%%", cpuData.currentValue);
             
             ImGui::Checkbox("Pause", &cpuData.isPaused);
-            ImGui::SliderInt("FPS", &cpuData.fps, 1, 60);
+            if (ImGui::SliderInt("FPS", &cpuData.fps, 1, 60)) {
+                setMetricRate(METRIC_CPU, cpuData.fps);
+            }
             ImGui::SliderFloat("Y Scale", &cpuData.yScale, 0.1f, 2.0f);
+            int cpuHistory = cpuData.historyLength;
+            if (ImGui::SliderInt("History", &cpuHistory, 100, PERFORMANCE_HISTORY_MAX, "%d samples", ImGuiSliderFlags_Logarithmic)) {
+                setPerformanceHistory(cpuData, cpuHistory);
+            }
             
             ImVec2 graphSize(ImGui::GetWindowWidth() - 20, 200);
-            ImGui::PlotLines("##CPU", cpuData.values.data(), cpuData.values.size(), 
+            ImGui::PlotLines("##CPU", getPerformanceValue, &cpuData, cpuData.historyLength,
                            0, NULL, 0.0f, 100.0f * cpuData.yScale, graphSize);
+
+            // where the busy time went: steal and iowait explain most latency on shared hosts
+            ImGui::Text("CPU time breakdown:");
+            float legendRight = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
+            for (int k = 0; k < CPU_TIME_SERIES; k++) {
+                char label[32];
+                snprintf(label, sizeof(label), "%s %.1f%%", cpuTimeSeries[k].name, cpuTimes[k].currentValue);
+                // wrap the legend instead of running past the window edge
+                float next = ImGui::GetItemRectMax().x + ImGui::GetStyle().ItemSpacing.x + ImGui::CalcTextSize(label).x;
+                if (next < legendRight) ImGui::SameLine();
+                ImGui::TextColored(ImColor(cpuTimeSeries[k].color), "%s", label);
+            }
+            stackedPlot("##CPUTimes", cpuTimes, CPU_TIME_SERIES, 100.0f * cpuData.yScale, ImVec2(ImGui::GetWindowWidth() - 20, 150));
+
+            const CPUSample& cpuSample = getLatestCPUSample();
+            ImGui::Text("Per-core usage (%d CPUs)", static_cast<int>(cpuSample.cores.size()));
+            cpuHeatmap(cpuSample);
             
             ImGui::EndTabItem();
         }
@@ -120,12 +435,25 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
             ImGui::Text("Level: %d%%", (int)((fanData.currentValue * 100) / 5000));
             
             ImGui::Checkbox("Pause", &fanData.isPaused);
-            ImGui::SliderInt("FPS", &fanData.fps, 1, 60);
+            if (ImGui::SliderInt("FPS", &fanData.fps, 1, 60)) {
+                setMetricRate(METRIC_FAN, fanData.fps);
+            }
             ImGui::SliderFloat("Y Scale", &fanData.yScale, 0.1f, 2.0f);
+            int fanHistory = fanData.historyLength;
+            if (ImGui::SliderInt("History", &fanHistory, 100, PERFORMANCE_HISTORY_MAX, "%d samples", ImGuiSliderFlags_Logarithmic)) {
+                setPerformanceHistory(fanData, fanHistory);
+            }
             
             ImVec2 graphSize(ImGui::GetWindowWidth() - 20, 200);
-            ImGui::PlotLines("##Fan", fanData.values.data(), fanData.values.size(), 
+            ImGui::PlotLines("##Fan", getPerformanceValue, &fanData, fanData.historyLength,
                            0, NULL, 0.0f, 5000.0f * fanData.yScale, graphSize);
+
+            const SensorSample& sensorSample = getLatestSensorSample();
+            ImGui::Text("Fans (click one to graph it):");
+            if (sensorTable("##Fans", sensorSample, SENSOR_FAN, "%.0f RPM")) {
+                fanData.values.reset(fanData.values.capacity());
+                fanData.lastTime = 0.0;
+            }
             
             ImGui::EndTabItem();
         }
@@ -135,15 +463,34 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
             ImGui::Text("Temperature: %.1f°C", thermalData.currentValue);
             
             ImGui::Checkbox("Pause", &thermalData.isPaused);
-            ImGui::SliderInt("FPS", &thermalData.fps, 1, 60);
+            if (ImGui::SliderInt("FPS", &thermalData.fps, 1, 60)) {
+                setMetricRate(METRIC_THERMAL, thermalData.fps);
+            }
             ImGui::SliderFloat("Y Scale", &thermalData.yScale, 0.1f, 2.0f);
+            int thermalHistory = thermalData.historyLength;
+            if (ImGui::SliderInt("History", &thermalHistory, 100, PERFORMANCE_HISTORY_MAX, "%d samples", ImGuiSliderFlags_Logarithmic)) {
+                setPerformanceHistory(thermalData, thermalHistory);
+            }
             
             ImVec2 graphSize(ImGui::GetWindowWidth() - 20, 200);
-            ImGui::PlotLines("##Thermal", thermalData.values.data(), thermalData.values.size(), 
+            ImGui::PlotLines("##Thermal", getPerformanceValue, &thermalData, thermalData.historyLength,
                            0, NULL, 0.0f, 100.0f * thermalData.yScale, graphSize);
+
+            const SensorSample& sensorSample = getLatestSensorSample();
+            ImGui::Text("Temperature sensors (click one to graph it):");
+            if (sensorTable("##Temperatures", sensorSample, SENSOR_TEMPERATURE, "%.1f°C")) {
+                thermalData.values.reset(thermalData.values.capacity());
+                thermalData.lastTime = 0.0;
+            }
             
             ImGui::EndTabItem();
         }
+
+        // Pressure Tab
+        if (ImGui::BeginTabItem("Pressure")) {
+            pressureTab(snapshot);
+            ImGui::EndTabItem();
+        }
         
         ImGui::EndTabBar();
     }
@@ -151,6 +498,161 @@ void systemWindow(const char *id, ImVec2 size, ImVec2 position)
     ImGui::End();
 }
 
+// Memory fields with a rolling history in the Memory tab
+struct MemorySeries
+{
+    const char* name;
+    uint64_t MemoryInfo::*field;
+};
+static const MemorySeries memorySeries[] = {
+    { "Used",          &MemoryInfo::usedRam },
+    { "Available",     &MemoryInfo::availableRam },
+    { "Free",          &MemoryInfo::freeRam },
+    { "Buffers",       &MemoryInfo::buffers },
+    { "Cached",        &MemoryInfo::cached },
+    { "SReclaimable",  &MemoryInfo::sReclaimable },
+    { "Shmem",         &MemoryInfo::shmem },
+    { "Dirty",         &MemoryInfo::dirty },
+    { "Writeback",     &MemoryInfo::writeback },
+    { "AnonPages",     &MemoryInfo::anonPages },
+    { "Mapped",        &MemoryInfo::mapped },
+    { "Slab",          &MemoryInfo::slab },
+    { "HugePages",     &MemoryInfo::hugePagesTotal },
+};
+static const int MEMORY_SERIES = sizeof(memorySeries) / sizeof(memorySeries[0]);
+static const size_t MEMORY_HISTORY = 3600;   // an hour of 1 Hz refreshes
+
+// memoryBar, split physical memory into stacked segments that add up to the total
+void memoryBar(const MemoryInfo& memInfo)
+{
+    if (memInfo.totalRam == 0) return;
+    uint64_t pageCache = memInfo.buffers + memInfo.cached;
+    pageCache = pageCache > memInfo.shmem ? pageCache - memInfo.shmem : 0;   // shmem is in Cached
+    struct Segment { const char* name; uint64_t bytes; ImU32 color; };
+    Segment segments[] = {
+        { "Applications", memInfo.anonPages,      IM_COL32(230,  90,  70, 255) },
+        { "Shmem",        memInfo.shmem,          IM_COL32(240, 160,  60, 255) },
+        { "Slab",         memInfo.slab,           IM_COL32(170,  90, 210, 255) },
+        { "Huge pages",   memInfo.hugePagesTotal, IM_COL32(120, 120, 200, 255) },
+        { "Page cache",   pageCache,              IM_COL32( 70, 130, 230, 255) },
+        { "Other",        0,                      IM_COL32(140, 140, 140, 255) },
+        { "Free",         memInfo.freeRam,        IM_COL32( 80, 190,  90, 255) },
+    };
+    const int count = sizeof(segments) / sizeof(segments[0]);
+    // kernel stacks, page tables, vmalloc and the like fill whatever is left
+    uint64_t accounted = 0;
+    for (const Segment& segment : segments) accounted += segment.bytes;
+    segments[count - 2].bytes = accounted < memInfo.totalRam ? memInfo.totalRam - accounted : 0;
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 size(ImGui::GetContentRegionAvail().x, ImGui::GetFrameHeight());
+    ImGui::InvisibleButton("##MemoryBar", size);
+    bool hovered = ImGui::IsItemHovered();
+    float mouseX = ImGui::GetIO().MousePos.x;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    float x = origin.x;
+    float scale = size.x / static_cast<float>(max(accounted, memInfo.totalRam));
+    for (const Segment& segment : segments) {
+        float width = segment.bytes * scale;
+        if (width <= 0.0f) continue;
+        drawList->AddRectFilled(ImVec2(x, origin.y), ImVec2(x + width, origin.y + size.y), segment.color);
+        if (hovered && mouseX >= x && mouseX < x + width) {
+            ImGui::SetTooltip("%s: %s (%.1f%%)", segment.name, formatBytes(segment.bytes).c_str(),
+                              100.0f * segment.bytes / memInfo.totalRam);
+        }
+        x += width;
+    }
+
+    float legendRight = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
+    for (int i = 0; i < count; i++) {
+        float next = ImGui::GetItemRectMax().x + ImGui::GetStyle().ItemSpacing.x + ImGui::CalcTextSize(segments[i].name).x;
+        if (i > 0 && next < legendRight) ImGui::SameLine();
+        ImGui::TextColored(ImColor(segments[i].color), "%s", segments[i].name);
+    }
+}
+
+// cgroupTable, collapsible cgroup tree; only the rows on screen are submitted, so
+// thousands of cgroups cost no more than a screenful
+void cgroupTable(const SystemSnapshot& snapshot)
+{
+    const vector<CgroupStats>& cgroups = snapshot.cgroups;
+    static unordered_set<string> expanded = { "" };   // paths of the open cgroups, the root starts open
+    static vector<int> visibleRows;                   // indices into `cgroups` not hidden by a closed ancestor
+    static uint64_t cgroupGeneration = 0;
+    static bool expansionChanged = true;
+
+    if (snapshot.cgroupGeneration != cgroupGeneration || expansionChanged) {
+        cgroupGeneration = snapshot.cgroupGeneration;
+        expansionChanged = false;
+        visibleRows.clear();
+        for (size_t i = 0; i < cgroups.size(); ) {
+            visibleRows.push_back(static_cast<int>(i));
+            // skip the whole subtree of a closed cgroup
+            i = expanded.count(cgroups[i].path) ? i + 1 : cgroups[i].subtreeEnd;
+        }
+    }
+
+    ImGui::Text("%zu cgroups", cgroups.size());
+    if (!ImGui::BeginTable("CgroupTable", 7,
+        ImGuiTableFlags_Borders |
+        ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_ScrollY |
+        ImGuiTableFlags_Resizable)) {
+        return;
+    }
+    ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, -1.0f);
+    ImGui::TableSetupColumn("CPU %", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+    ImGui::TableSetupColumn("Memory", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+    ImGui::TableSetupColumn("Anon", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+    ImGui::TableSetupColumn("File", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+    ImGui::TableSetupColumn("Read/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+    ImGui::TableSetupColumn("Write/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+    ImGui::TableSetupScrollFreeze(0, 1);  // keep the header visible
+    ImGui::TableHeadersRow();
+
+    float indent = ImGui::GetStyle().IndentSpacing;
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(visibleRows.size()));
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            int index = visibleRows[row];
+            const CgroupStats& cgroup = cgroups[index];
+            ImGui::TableNextRow();
+
+            // the tree is drawn by indenting each row, not by nesting tree nodes,
+            // so a row can be submitted without its ancestors
+            ImGui::TableNextColumn();
+            bool hasChildren = cgroup.subtreeEnd > index + 1;
+            bool isOpen = expanded.count(cgroup.path) != 0;
+            ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth |
+                                       (hasChildren ? ImGuiTreeNodeFlags_OpenOnArrow : ImGuiTreeNodeFlags_Leaf);
+            if (cgroup.depth > 0) ImGui::Indent(cgroup.depth * indent);
+            ImGui::SetNextItemOpen(isOpen);
+            bool open = ImGui::TreeNodeEx(cgroup.path.c_str(), flags, "%s", cgroup.name.c_str());
+            if (cgroup.depth > 0) ImGui::Unindent(cgroup.depth * indent);
+            if (hasChildren && open != isOpen) {
+                if (open) expanded.insert(cgroup.path); else expanded.erase(cgroup.path);
+                expansionChanged = true;
+            }
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", cgroup.cpuPercent);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(cgroup.hasMemory ? formatBytes(cgroup.memoryCurrent).c_str() : "-");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(cgroup.hasMemory ? formatBytes(cgroup.memoryAnon).c_str() : "-");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(cgroup.hasMemory ? formatBytes(cgroup.memoryFile).c_str() : "-");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(cgroup.hasIO ? (formatBytes(static_cast<uint64_t>(cgroup.ioReadRate)) + "/s").c_str() : "-");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(cgroup.hasIO ? (formatBytes(static_cast<uint64_t>(cgroup.ioWriteRate)) + "/s").c_str() : "-");
+        }
+    }
+    ImGui::EndTable();
+}
+
 // memoryProcessesWindow, display information for the memory and processes information
 void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
 {
@@ -158,16 +660,19 @@ void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
     ImGui::SetWindowSize(id, size);
     ImGui::SetWindowPos(id, position);
 
-    static MemoryInfo memInfo = getMemoryInfoFromProc();  // Using the new method
-    static vector<DiskInfo> diskInfo = getDiskInfo();
-    static time_t lastUpdate = 0;
-    time_t currentTime = time(nullptr);
-    
-    // Update information every second
-    if (currentTime - lastUpdate >= 1) {
-        memInfo = getMemoryInfoFromProc();  // Using the new method
-        diskInfo = getDiskInfo();
-        lastUpdate = currentTime;
+    // Memory, disks and processes are refreshed every second by the sampler
+    const SystemSnapshot& snapshot = getLatestSnapshot();
+    const MemoryInfo& memInfo = snapshot.memInfo;
+    const vector<DiskInfo>& diskInfo = snapshot.diskInfo;
+
+    // keep recording while another tab is open, so pressure building up is not missed
+    static vector<RingBuffer<float>> memoryHistory(MEMORY_SERIES, RingBuffer<float>(MEMORY_HISTORY));
+    static double lastMemoryTime = 0.0;
+    if (snapshot.memoryTime != lastMemoryTime) {
+        lastMemoryTime = snapshot.memoryTime;
+        for (int i = 0; i < MEMORY_SERIES; i++) {
+            memoryHistory[i].push(static_cast<float>(memInfo.*memorySeries[i].field));
+        }
     }
 
     if (ImGui::BeginTabBar("MemoryTabs")) {
@@ -178,18 +683,38 @@ void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
             float ramUsage = getMemoryUsagePercentageFromProc(memInfo);  // Using the new calculation method
             ImGui::Text("Total: %s", formatBytes(memInfo.totalRam).c_str());
             ImGui::Text("Used: %s (%.1f%%)", formatBytes(memInfo.usedRam).c_str(), ramUsage);
+            ImGui::Text("Available: %s", formatBytes(memInfo.availableRam).c_str());
             ImGui::Text("Free: %s", formatBytes(memInfo.freeRam).c_str());
             
-            // Add detailed memory information
-            ImGui::Separator();
-            ImGui::Text("Memory Details:");
-            ImGui::Text("Buffers: %s", formatBytes(memInfo.freeRam - (memInfo.totalRam - memInfo.usedRam)).c_str());
-            ImGui::Text("Cached: %s", formatBytes(memInfo.freeRam - (memInfo.totalRam - memInfo.usedRam)).c_str());
-            ImGui::Text("Actual Used: %s", formatBytes(memInfo.totalRam - memInfo.freeRam).c_str());
-            
             ImGui::ProgressBar(ramUsage / 100.0f, ImVec2(-1, 0));
             ImGui::SameLine();
             ImGui::Text("%.1f%%", ramUsage);
+            memoryBar(memInfo);
+
+            // Add detailed memory information
+            ImGui::Separator();
+            ImGui::Text("Memory Details (last hour):");
+            if (ImGui::BeginTable("MemoryDetails", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Field", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+                ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch, -1.0f);
+                ImGui::TableHeadersRow();
+                for (int i = 0; i < MEMORY_SERIES; i++) {
+                    const RingBuffer<float>& history = memoryHistory[i];
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", memorySeries[i].name);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%s", formatBytes(memInfo.*memorySeries[i].field).c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::PushID(i);
+                    // each row scales to its own peak, Dirty is tiny next to Cached
+                    ImGui::PlotLines("##history", history.data(), static_cast<int>(history.size()), history.plotOffset(),
+                                     NULL, 0.0f, FLT_MAX, ImVec2(-1, ImGui::GetTextLineHeight()));
+                    ImGui::PopID();
+                }
+                ImGui::EndTable();
+            }
 
             ImGui::Separator();
 
@@ -224,71 +749,165 @@ void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
 
         // Processes Tab
         if (ImGui::BeginTabItem("Processes")) {
-            static vector<Proc> processes = getProcessList();
+            // The sampler keeps rows in a stable order and formats them once per scan,
+            // so a refresh neither reorders the table nor costs the frame anything
+            const vector<Proc>& processes = snapshot.processes;
+            const vector<ProcRowText>& rowText = snapshot.processText;
+            static vector<int> visibleRows;        // indices into `processes` that match the search, in sort order
+            static size_t sortedRows = 0;          // how many of `visibleRows` are sorted so far
+            static int sortColumn = PROC_COLUMN_PID;
+            static bool sortDescending = false;
+            static uint64_t processGeneration = 0;
             static char searchBuffer[256] = "";
-            static vector<int> selectedProcesses;  // Store selected PIDs
+            static char lastSearch[256] = "";
+            static ProcQuery query;
+            static ProcQuery previousQuery;        // query of `lastSearch`, reused to keep its buffers
+            static unordered_set<int> selectedProcesses;  // Store selected PIDs
+            static bool perCoreCPU = false;        // divide CPU % by the number of cores
+            static float refreshSeconds = 1.0f;
+
             ImGui::InputText("Search", searchBuffer, sizeof(searchBuffer));
-            
-            if (ImGui::BeginTable("ProcessTable", 5, 
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Words match name, PID or command line\n"
+                                  "user:NAME  owner contains NAME\n"
+                                  "state:R    process state\n"
+                                  "re:REGEX   name or command line matches REGEX");
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("CPU % of all cores", &perCoreCPU);
+            ImGui::SetNextItemWidth(200.0f);
+            if (ImGui::SliderFloat("Refresh (s)", &refreshSeconds, 0.5f, 10.0f, "%.1f")) {
+                setProcessRefreshInterval(static_cast<int>(refreshSeconds * 1000.0f));
+            }
+
+            bool newScan = snapshot.processGeneration != processGeneration;
+            if (newScan) {
+                processGeneration = snapshot.processGeneration;
+
+                // forget selected processes that have exited
+                if (!selectedProcesses.empty()) {
+                    unordered_set<int> alive;
+                    for (const auto& proc : processes) alive.insert(proc.pid);
+                    for (auto it = selectedProcesses.begin(); it != selectedProcesses.end();) {
+                        it = alive.count(*it) ? std::next(it) : selectedProcesses.erase(it);
+                    }
+                }
+            }
+
+            // Filter by search term only when the rows or the term change
+            if (newScan || strcmp(searchBuffer, lastSearch) != 0) {
+                swap(previousQuery, query);
+                parseProcQuery(searchBuffer, query);
+
+                // When the new query can only match fewer processes, filter the rows
+                // that already matched instead of every process
+                bool narrowing = !newScan && narrowsProcQuery(previousQuery, query);
+                if (narrowing) {
+                    size_t kept = 0;
+                    size_t keptSorted = 0;
+                    for (size_t i = 0; i < visibleRows.size(); i++) {
+                        int index = visibleRows[i];
+                        if (matchProcess(query, processes[index], rowText[index], snapshot.processSearch[index])) {
+                            if (i < sortedRows) keptSorted++;  // a subsequence of a sorted prefix stays sorted
+                            visibleRows[kept++] = index;
+                        }
+                    }
+                    visibleRows.resize(kept);
+                    sortedRows = keptSorted;
+                } else {
+                    visibleRows.clear();
+                    for (size_t i = 0; i < processes.size(); i++) {
+                        if (matchProcess(query, processes[i], rowText[i], snapshot.processSearch[i])) {
+                            visibleRows.push_back(static_cast<int>(i));
+                        }
+                    }
+                    sortedRows = 0;
+                }
+                strcpy(lastSearch, searchBuffer);
+            }
+            if (query.hasRegex && !query.regexValid) {
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Invalid regex");
+            }
+
+            if (ImGui::BeginTable("ProcessTable", 9, 
                 ImGuiTableFlags_Borders | 
                 ImGuiTableFlags_RowBg | 
-                ImGuiTableFlags_ScrollY)) {
+                ImGuiTableFlags_ScrollY |
+                ImGuiTableFlags_Sortable |
+                ImGuiTableFlags_Hideable)) {
                 
-                ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed, 80.0f);
-                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 60.0f);
-                ImGui::TableSetupColumn("CPU %", ImGuiTableColumnFlags_WidthFixed, 80.0f);
-                ImGui::TableSetupColumn("Memory %", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+                ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort, 80.0f, PROC_COLUMN_PID);
+                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, -1.0f, PROC_COLUMN_NAME);
+                ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 60.0f, PROC_COLUMN_STATE);
+                ImGui::TableSetupColumn("CPU %", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 80.0f, PROC_COLUMN_CPU);
+                ImGui::TableSetupColumn("Memory %", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 100.0f, PROC_COLUMN_MEMORY);
+                ImGui::TableSetupColumn("Read/s", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 90.0f, PROC_COLUMN_READ);
+                ImGui::TableSetupColumn("Write/s", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 90.0f, PROC_COLUMN_WRITE);
+                // syscall counts include page cache hits; right-click the header to show them
+                ImGui::TableSetupColumn("Reads/s", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultHide, 70.0f, PROC_COLUMN_SYSCR);
+                ImGui::TableSetupColumn("Writes/s", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultHide, 70.0f, PROC_COLUMN_SYSCW);
+                ImGui::TableSetupScrollFreeze(0, 1);  // keep the header visible
                 ImGui::TableHeadersRow();
 
-                // Calculate total system memory for percentage
-                float totalMemoryKB = memInfo.totalRam / 1024.0f;  // Convert to KB
-
-                for (const auto& proc : processes) {
-                    // Filter by search term if any
-                    if (strlen(searchBuffer) > 0) {
-                        if (proc.name.find(searchBuffer) == string::npos &&
-                            to_string(proc.pid).find(searchBuffer) == string::npos) {
-                            continue;
-                        }
+                // Re-sort only when the sort spec changes; a new scan or search already reset `sortedRows`
+                ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs();
+                if (sortSpecs != nullptr && sortSpecs->SpecsDirty) {
+                    if (sortSpecs->SpecsCount > 0) {
+                        sortColumn = sortSpecs->Specs[0].ColumnUserID;
+                        sortDescending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
                     }
+                    sortSpecs->SpecsDirty = false;
+                    sortedRows = 0;
+                }
+                // CPU, memory and I/O are sorted lazily, only as far down as the table is scrolled
+                bool partialSort = sortColumn != PROC_COLUMN_PID && sortColumn != PROC_COLUMN_NAME &&
+                                   sortColumn != PROC_COLUMN_STATE;
 
-                    ImGui::TableNextRow();
-                    
-                    // Check if this row is selected
-                    bool isSelected = std::find(selectedProcesses.begin(), 
-                                             selectedProcesses.end(), 
-                                             proc.pid) != selectedProcesses.end();
-                    
-                    // Make the entire row selectable
-                    if (ImGui::TableNextColumn()) {
-                        if (ImGui::Selectable(to_string(proc.pid).c_str(), isSelected, 
-                            ImGuiSelectableFlags_SpanAllColumns)) {
-                            // Toggle selection
-                            auto it = std::find(selectedProcesses.begin(), 
-                                             selectedProcesses.end(), 
-                                             proc.pid);
-                            if (it != selectedProcesses.end()) {
-                                selectedProcesses.erase(it);
-                            } else {
-                                selectedProcesses.push_back(proc.pid);
+                // Only submit the rows that are actually on screen
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(visibleRows.size()));
+                while (clipper.Step()) {
+                    size_t wantRows = partialSort ? clipper.DisplayEnd * 2 + 64 : visibleRows.size();
+                    sortedRows = sortProcessRows(visibleRows, processes, sortColumn, sortDescending,
+                                                 sortedRows, wantRows);
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                        const Proc& proc = processes[visibleRows[row]];
+                        const ProcRowText& text = rowText[visibleRows[row]];
+
+                        ImGui::TableNextRow();
+
+                        // Make the entire row selectable
+                        bool isSelected = selectedProcesses.count(proc.pid) != 0;
+                        if (ImGui::TableNextColumn()) {
+                            if (ImGui::Selectable(text.pid, isSelected, 
+                                ImGuiSelectableFlags_SpanAllColumns)) {
+                                // Toggle selection
+                                if (isSelected) {
+                                    selectedProcesses.erase(proc.pid);
+                                } else {
+                                    selectedProcesses.insert(proc.pid);
+                                }
                             }
                         }
+                        
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(proc.name.c_str());
+                        
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%c", proc.state);
+                        
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(perCoreCPU ? text.cpuAllCores : text.cpu);
+                        
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(text.memory);
+
+                        // hidden columns return false and skip their text
+                        if (ImGui::TableNextColumn()) ImGui::TextUnformatted(text.readRate);
+                        if (ImGui::TableNextColumn()) ImGui::TextUnformatted(text.writeRate);
+                        if (ImGui::TableNextColumn()) ImGui::TextUnformatted(text.syscrRate);
+                        if (ImGui::TableNextColumn()) ImGui::TextUnformatted(text.syscwRate);
                     }
-                    
-                    ImGui::TableNextColumn();
-                    ImGui::Text("%s", proc.name.c_str());
-                    
-                    ImGui::TableNextColumn();
-                    ImGui::Text("%c", proc.state);
-                    
-                    ImGui::TableNextColumn();
-                    float cpuPercent = calculateCPUPercentage(proc);
-                    ImGui::Text("%.1f%%", cpuPercent);
-                    
-                    ImGui::TableNextColumn();
-                    float memoryPercent = (proc.rss * 4.0f) / totalMemoryKB * 100.0f;  // Convert pages to KB then to percentage
-                    ImGui::Text("%.1f%%", memoryPercent);
                 }
                 ImGui::EndTable();
             }
@@ -301,6 +920,16 @@ void memoryProcessesWindow(const char *id, ImVec2 size, ImVec2 position)
             ImGui::EndTabItem();
         }
 
+        // Cgroups Tab
+        if (ImGui::BeginTabItem("Cgroups")) {
+            if (snapshot.cgroups.empty()) {
+                ImGui::TextDisabled("No cgroup v2 hierarchy found");
+            } else {
+                cgroupTable(snapshot);
+            }
+            ImGui::EndTabItem();
+        }
+
         ImGui::EndTabBar();
     }
 
@@ -322,20 +951,47 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
     ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Current Time: %s", timeStr);  // Green color for visibility
     ImGui::Separator();
 
-    static vector<NetworkStats> networkStats = getAllNetworkStats();
-    static time_t lastUpdate = 0;
-    time_t currentTime = time(nullptr);
-    
-    // Update network stats every second
-    if (currentTime - lastUpdate >= 1) {
-        networkStats = getAllNetworkStats();
-        lastUpdate = currentTime;
+    // Network stats are refreshed every second by the sampler
+    const SystemSnapshot& snapshot = getLatestSnapshot();
+    const vector<NetworkStats>& networkStats = snapshot.networkStats;
+
+    // Keep a rolling rate history per interface, one sample per refresh
+    static unordered_map<string, InterfaceHistory> history;
+    static double lastNetworkTime = 0.0;
+    if (snapshot.networkTime != lastNetworkTime) {
+        for (auto& entry : history) entry.second.seen = false;
+        for (const auto& stats : networkStats) {
+            InterfaceHistory& rates = history[stats.interface];
+            rates.rx_bytes_rate.push(stats.rx_bytes_rate);
+            rates.tx_bytes_rate.push(stats.tx_bytes_rate);
+            rates.seen = true;
+        }
+        // forget interfaces that were removed
+        for (auto it = history.begin(); it != history.end();) {
+            it = it->second.seen ? std::next(it) : history.erase(it);
+        }
+        lastNetworkTime = snapshot.networkTime;
     }
 
     // Display network interfaces and their IPv4 addresses
     ImGui::Text("Network Interfaces:");
     for (const auto& stats : networkStats) {
         ImGui::Text("%s: %s", stats.interface.c_str(), stats.ipv4.c_str());
+        // any further IPv4 and every IPv6 address on the same interface
+        for (size_t i = 1; i < stats.addresses.ipv4.size(); i++) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(stats.addresses.ipv4[i].c_str());
+        }
+        for (const auto& address : stats.addresses.ipv6) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("%s", address.c_str());
+        }
+    }
+
+    // rtnetlink reads every link in one round-trip, /proc/net/dev is the text fallback
+    static bool useNetlink = true;
+    if (ImGui::Checkbox("Use rtnetlink", &useNetlink)) {
+        setNetlinkEnabled(useNetlink);
     }
 
     ImGui::Separator();
@@ -343,9 +999,11 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
     if (ImGui::BeginTabBar("NetworkTabs")) {
         // RX Statistics Tab
         if (ImGui::BeginTabItem("RX Statistics")) {
-            if (ImGui::BeginTable("RXTable", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            if (ImGui::BeginTable("RXTable", 10, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
                 ImGui::TableSetupColumn("Interface");
                 ImGui::TableSetupColumn("Bytes");
+                ImGui::TableSetupColumn("Bytes/s");
+                ImGui::TableSetupColumn("Packets/s");
                 ImGui::TableSetupColumn("Packets");
                 ImGui::TableSetupColumn("Errors");
                 ImGui::TableSetupColumn("Drops");
@@ -361,6 +1019,10 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
                     ImGui::TableNextColumn();
                     ImGui::Text("%s", formatBytes(stats.rx_bytes).c_str());
                     ImGui::TableNextColumn();
+                    ImGui::Text("%s/s", formatBytes(stats.rx_bytes_rate).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.0f", stats.rx_packets_rate);
+                    ImGui::TableNextColumn();
                     ImGui::Text("%llu", stats.rx_packets);
                     ImGui::TableNextColumn();
                     ImGui::Text("%llu", stats.rx_errs);
@@ -380,9 +1042,11 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
 
         // TX Statistics Tab
         if (ImGui::BeginTabItem("TX Statistics")) {
-            if (ImGui::BeginTable("TXTable", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            if (ImGui::BeginTable("TXTable", 10, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
                 ImGui::TableSetupColumn("Interface");
                 ImGui::TableSetupColumn("Bytes");
+                ImGui::TableSetupColumn("Bytes/s");
+                ImGui::TableSetupColumn("Packets/s");
                 ImGui::TableSetupColumn("Packets");
                 ImGui::TableSetupColumn("Errors");
                 ImGui::TableSetupColumn("Drops");
@@ -398,6 +1062,10 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
                     ImGui::TableNextColumn();
                     ImGui::Text("%s", formatBytes(stats.tx_bytes).c_str());
                     ImGui::TableNextColumn();
+                    ImGui::Text("%s/s", formatBytes(stats.tx_bytes_rate).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.0f", stats.tx_packets_rate);
+                    ImGui::TableNextColumn();
                     ImGui::Text("%llu", stats.tx_packets);
                     ImGui::TableNextColumn();
                     ImGui::Text("%llu", stats.tx_errs);
@@ -417,33 +1085,39 @@ void networkWindow(const char *id, ImVec2 size, ImVec2 position)
 
         // Visual Usage Tab
         if (ImGui::BeginTabItem("Visual Usage")) {
-            const float maxGB = 2.0f;  // Maximum display value in GB
-            const float maxBytes = maxGB * 1024 * 1024 * 1024;  // Convert to bytes
-
-            // RX Progress Bars
-            ImGui::Text("RX Usage:");
-            for (const auto& stats : networkStats) {
-                float progress = static_cast<float>(stats.rx_bytes) / maxBytes;
-                progress = std::min(progress, 1.0f);  // Cap at 100%
-                
-                ImGui::Text("%s: %s", stats.interface.c_str(), formatBytes(stats.rx_bytes).c_str());
-                ImGui::ProgressBar(progress, ImVec2(-1, 0));
-                ImGui::SameLine();
-                ImGui::Text("2.00 GB");
-            }
+            // One row per interface, only the visible ones are drawn
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(networkStats.size()));
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const NetworkStats& stats = networkStats[i];
+                    const InterfaceHistory& rates = history[stats.interface];
 
-            ImGui::Separator();
+                    // Scale to the link speed when the driver reports one, else to the busiest sample
+                    float maxRate = stats.speedMbps > 0 ? stats.speedMbps * 1000000.0f / 8.0f : 0.0f;
+                    if (maxRate == 0.0f) {
+                        for (size_t j = 0; j < rates.rx_bytes_rate.size(); j++) {
+                            maxRate = std::max(maxRate, std::max(rates.rx_bytes_rate[j], rates.tx_bytes_rate[j]));
+                        }
+                        maxRate = std::max(maxRate, 1024.0f);
+                    }
 
-            // TX Progress Bars
-            ImGui::Text("TX Usage:");
-            for (const auto& stats : networkStats) {
-                float progress = static_cast<float>(stats.tx_bytes) / maxBytes;
-                progress = std::min(progress, 1.0f);  // Cap at 100%
-                
-                ImGui::Text("%s: %s", stats.interface.c_str(), formatBytes(stats.tx_bytes).c_str());
-                ImGui::ProgressBar(progress, ImVec2(-1, 0));
-                ImGui::SameLine();
-                ImGui::Text("2.00 GB");
+                    ImGui::PushID(i);
+                    if (stats.speedMbps > 0) {
+                        ImGui::Text("%s (%d Mbit/s)  RX %s/s  TX %s/s", stats.interface.c_str(), stats.speedMbps,
+                                    formatBytes(stats.rx_bytes_rate).c_str(), formatBytes(stats.tx_bytes_rate).c_str());
+                    } else {
+                        ImGui::Text("%s  RX %s/s  TX %s/s", stats.interface.c_str(),
+                                    formatBytes(stats.rx_bytes_rate).c_str(), formatBytes(stats.tx_bytes_rate).c_str());
+                    }
+                    float plotWidth = (ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ItemSpacing.x) / 2;
+                    ImGui::PlotLines("##RX", rates.rx_bytes_rate.data(), static_cast<int>(rates.rx_bytes_rate.size()),
+                                     rates.rx_bytes_rate.plotOffset(), "RX", 0.0f, maxRate, ImVec2(plotWidth, 40));
+                    ImGui::SameLine();
+                    ImGui::PlotLines("##TX", rates.tx_bytes_rate.data(), static_cast<int>(rates.tx_bytes_rate.size()),
+                                     rates.tx_bytes_rate.plotOffset(), "TX", 0.0f, maxRate, ImVec2(plotWidth, 40));
+                    ImGui::PopID();
+                }
             }
             ImGui::EndTabItem();
         }
@@ -524,6 +1198,9 @@ int main(int, char **)
     // note : you are free to change the style of the application
     ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
 
+    // collect system information on a background thread
+    startSampler();
+
     // Main loop
     bool done = false;
     while (!done)
@@ -548,6 +1225,9 @@ int main(int, char **)
         ImGui_ImplSDL2_NewFrame(window);
         ImGui::NewFrame();
 
+        // pick up the sampler's newest snapshot, without ever waiting on it
+        updateSnapshot();
+
         {
             ImVec2 mainDisplay = io.DisplaySize;
             memoryProcessesWindow("== Memory and Processes ==",
@@ -573,6 +1253,7 @@ int main(int, char **)
     }
 
     // Cleanup
+    stopSampler();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -1,31 +1,16 @@
 #include "header.h"
-#include <sys/sysinfo.h>
 #include <sys/statvfs.h>
 #include <cstdio>
 #include <cstring>
 #include <sstream>
 #include <map>
+#include <unordered_map>
+#include <algorithm>
 #include <ctime>
-
-// Get memory information (RAM and SWAP)
-MemoryInfo getMemoryInfo() {
-    MemoryInfo info = {0, 0, 0, 0, 0, 0};
-    struct sysinfo si;
-    
-    if (sysinfo(&si) == 0) {
-        // RAM information
-        info.totalRam = si.totalram;
-        info.freeRam = si.freeram;
-        info.usedRam = info.totalRam - info.freeRam;
-        
-        // SWAP information
-        info.totalSwap = si.totalswap;
-        info.freeSwap = si.freeswap;
-        info.usedSwap = info.totalSwap - info.freeSwap;
-    }
-    
-    return info;
-}
+#include <cerrno>
+// openat/read for the /proc/[pid]/stat parser
+#include <fcntl.h>
+#include <sys/stat.h>
 
 // Get disk usage information
 vector<DiskInfo> getDiskInfo() {
@@ -74,121 +59,691 @@ float getDiskUsagePercentage(const DiskInfo& disk) {
     return (static_cast<float>(disk.usedSpace) / disk.totalSpace) * 100.0f;
 }
 
-// Get process information
-vector<Proc> getProcessList() {
-    vector<Proc> processes;
+// Read the next space separated number of a /proc stat line, advancing `p`
+long long int parseStatField(const char*& p, const char* end) {
+    while (p < end && *p == ' ') p++;
+    bool negative = (p < end && *p == '-');
+    if (negative) p++;
+    long long int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    return negative ? -value : value;
+}
+
+// Skip `count` space separated fields of a /proc stat line
+static void skipStatFields(const char*& p, const char* end, int count) {
+    for (int i = 0; i < count; i++) {
+        while (p < end && *p == ' ') p++;
+        while (p < end && *p != ' ') p++;
+    }
+}
+
+// Parse one /proc/[pid]/stat line, see proc(5) for the field numbers.
+// `comm` may itself contain spaces and parentheses, so it spans from the first '(' to the last ')'.
+// assign() reuses the row's name buffer, so only a name longer than the row ever held allocates;
+// kernel threads and workqueues can have names well past TASK_COMM_LEN.
+bool parseProcStat(const char* buf, size_t len, Proc& proc) {
+    const char* end = buf + len;
+    const char* open = static_cast<const char*>(memchr(buf, '(', len));
+    const char* close = static_cast<const char*>(memrchr(buf, ')', len));
+    if (open == nullptr || close == nullptr || close < open || close + 2 >= end) return false;
+
+    const char* p = buf;
+    proc.pid = static_cast<int>(parseStatField(p, open));     // (1) pid
+    proc.name.assign(open + 1, close - open - 1);             // (2) comm
+
+    p = close + 2;
+    proc.state = *p++;                                        // (3) state
+    skipStatFields(p, end, 10);                               // (4) ppid .. (13) cmajflt
+    proc.utime = parseStatField(p, end);                      // (14) utime
+    proc.stime = parseStatField(p, end);                      // (15) stime
+    skipStatFields(p, end, 6);                                // (16) cutime .. (21) itrealvalue
+    proc.startTime = parseStatField(p, end);                  // (22) starttime
+    proc.vsize = parseStatField(p, end);                      // (23) vsize
+    proc.rss = parseStatField(p, end);                        // (24) rss
+    proc.cpuPercent = 0.0f;
+    proc.hasIO = false;
+    proc.readRate = proc.writeRate = proc.syscrRate = proc.syscwRate = 0.0f;
+    // the fields stop at `end` rather than fail, so a short read leaves `p` there; rss is
+    // only complete if something (rsslim, or at least the newline) follows it
+    return p < end;
+}
+
+// Read /proc/[pid]/stat relative to an open /proc directory into a stack buffer
+static bool readProcStat(int procFd, const char* pid, Proc& proc) {
+    char path[32];
+    snprintf(path, sizeof(path), "%s/stat", pid);
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;  // the process exited since readdir
+
+    char buf[1024];  // fields past rss may be cut off, we never read them
+    ssize_t len = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (len <= 0) return false;
+    return parseProcStat(buf, static_cast<size_t>(len), proc);
+}
+
+// Parse /proc/[pid]/io, one "key: value" line per counter
+bool parseProcIO(const char* buf, size_t len, ProcIO& io) {
+    static const struct { const char* key; uint64_t ProcIO::*field; } keys[] = {
+        { "syscr:",       &ProcIO::syscr },
+        { "syscw:",       &ProcIO::syscw },
+        { "read_bytes:",  &ProcIO::readBytes },
+        { "write_bytes:", &ProcIO::writeBytes },
+    };
+    const char* end = buf + len;
+    int found = 0;
+    for (const char* p = buf; p < end; ) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        for (const auto& key : keys) {
+            size_t keyLen = strlen(key.key);
+            if (static_cast<size_t>(lineEnd - p) > keyLen && memcmp(p, key.key, keyLen) == 0) {
+                const char* value = p + keyLen;
+                io.*key.field = static_cast<uint64_t>(parseStatField(value, lineEnd));
+                found++;
+                break;
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return found == 4;
+}
+
+// Get process information, reusing the rows (and their name buffers) already in `processes`
+void getProcessList(vector<Proc>& processes) {
+    size_t count = 0;
     DIR* procDir = opendir("/proc");
     if (procDir != nullptr) {
+        int procFd = dirfd(procDir);
         struct dirent* entry;
         while ((entry = readdir(procDir)) != nullptr) {
             if (isdigit(entry->d_name[0])) {
-                string statPath = "/proc/" + string(entry->d_name) + "/stat";
-                ifstream statFile(statPath);
-                if (statFile.is_open()) {
-                    string line;
-                    getline(statFile, line);
-                    stringstream ss(line);
-                    Proc proc;
-                    
-                    // Parse /proc/[pid]/stat
-                    ss >> proc.pid;  // pid
-                    string comm;
-                    ss >> comm;      // comm
-                    proc.name = comm.substr(1, comm.length() - 2);  // Remove parentheses
-                    ss >> proc.state;  // state
-                    
-                    // Skip fields until we get to the memory info
-                    for (int i = 0; i < 19; i++) ss >> comm;
-                    
-                    ss >> proc.vsize;  // virtual memory size
-                    ss >> proc.rss;    // resident set size
-                    
-                    // Skip fields until we get to the CPU time
-                    for (int i = 0; i < 2; i++) ss >> comm;
-                    
-                    ss >> proc.utime;  // user time
-                    ss >> proc.stime;  // system time
-                    
-                    processes.push_back(proc);
+                if (count == processes.size()) {
+                    processes.emplace_back();
+                }
+                if (readProcStat(procFd, entry->d_name, processes[count])) {
+                    count++;
                 }
             }
         }
         closedir(procDir);
     }
-    return processes;
-}
-
-// Calculate CPU percentage for a process
-float calculateCPUPercentage(const Proc& proc) {
-    static map<int, pair<unsigned long, unsigned long>> prevCPU;  // PID -> (prev_utime, prev_stime)
-    static time_t lastUpdate = 0;
-    time_t currentTime = time(nullptr);
-    
-    // Get current CPU times
-    unsigned long current_utime = proc.utime;
-    unsigned long current_stime = proc.stime;
-    
-    // Calculate time difference
-    float cpuPercent = 0.0f;
-    if (prevCPU.find(proc.pid) != prevCPU.end()) {
-        auto& prev = prevCPU[proc.pid];
-        unsigned long utime_diff = current_utime - prev.first;
-        unsigned long stime_diff = current_stime - prev.second;
-        float total_diff = (utime_diff + stime_diff) / 100.0f;  // Convert to seconds
-        
-        // Calculate percentage based on time difference and update interval
-        if (currentTime - lastUpdate > 0) {
-            cpuPercent = (total_diff / (currentTime - lastUpdate)) * 100.0f;
+    processes.resize(count);
+}
+
+// Bring `rows` up to date with a newer scan without rebuilding it: surviving
+// processes are updated in place and keep their position, new ones are appended
+// and exited ones removed, so the table neither reorders nor jumps while scrolled
+void applyProcessDiff(vector<Proc>& rows, const vector<Proc>& latest) {
+    static unordered_map<int, size_t> rowIndex;   // PID -> position in `rows`
+    static vector<char> seen;
+
+    rowIndex.clear();
+    for (size_t i = 0; i < rows.size(); i++) {
+        rowIndex[rows[i].pid] = i;
+    }
+    size_t oldCount = rows.size();
+    seen.assign(oldCount, 0);
+
+    for (const auto& proc : latest) {
+        auto it = rowIndex.find(proc.pid);
+        if (it != rowIndex.end() && rows[it->second].startTime == proc.startTime) {
+            rows[it->second] = proc;
+            seen[it->second] = 1;
+        } else {
+            rows.push_back(proc);  // new process, or a reused PID which gets a new row
         }
     }
-    
-    // Update previous values
-    prevCPU[proc.pid] = {current_utime, current_stime};
-    lastUpdate = currentTime;
-    
-    return cpuPercent;
+
+    // drop exited processes, keeping the order of everything else
+    size_t out = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (i >= oldCount || seen[i]) {
+            if (out != i) rows[out] = std::move(rows[i]);
+            out++;
+        }
+    }
+    rows.resize(out);
 }
 
-// Alternative method to get memory information using /proc/meminfo
-MemoryInfo getMemoryInfoFromProc() {
-    MemoryInfo info = {0, 0, 0, 0, 0, 0};
-    ifstream meminfo("/proc/meminfo");
-    if (meminfo.is_open()) {
-        string line;
-        map<string, uint64_t> memValues;
-        
-        while (getline(meminfo, line)) {
-            stringstream ss(line);
-            string key;
-            uint64_t value;
-            string unit;
-            
-            ss >> key >> value >> unit;
-            // Remove the colon from the key
-            if (!key.empty() && key.back() == ':') {
-                key.pop_back();
+// Format a byte rate like formatBytes() into a fixed buffer, so a scan does not allocate per row
+static void formatRate(char* out, size_t size, float bytesPerSecond) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit = 0;
+    double value = bytesPerSecond;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        unit++;
+    }
+    snprintf(out, size, "%.1f %s/s", value, units[unit]);
+}
+
+// Format the Processes table text of every row, once per scan
+void formatProcessRows(const vector<Proc>& processes, const MemoryInfo& memInfo, int cpuCount,
+                       vector<ProcRowText>& rows) {
+    float pageKB = sysconf(_SC_PAGESIZE) / 1024.0f;
+    float totalMemoryKB = memInfo.totalRam / 1024.0f;  // Convert to KB
+    rows.resize(processes.size());
+    for (size_t i = 0; i < processes.size(); i++) {
+        const Proc& proc = processes[i];
+        float memoryPercent = totalMemoryKB > 0 ? proc.rss * pageKB / totalMemoryKB * 100.0f : 0.0f;
+        snprintf(rows[i].pid, sizeof(rows[i].pid), "%d", proc.pid);
+        snprintf(rows[i].cpu, sizeof(rows[i].cpu), "%.1f%%", proc.cpuPercent);
+        snprintf(rows[i].cpuAllCores, sizeof(rows[i].cpuAllCores), "%.1f%%", proc.cpuPercent / cpuCount);
+        snprintf(rows[i].memory, sizeof(rows[i].memory), "%.1f%%", memoryPercent);
+        if (proc.hasIO) {
+            formatRate(rows[i].readRate, sizeof(rows[i].readRate), proc.readRate);
+            formatRate(rows[i].writeRate, sizeof(rows[i].writeRate), proc.writeRate);
+            snprintf(rows[i].syscrRate, sizeof(rows[i].syscrRate), "%.0f", proc.syscrRate);
+            snprintf(rows[i].syscwRate, sizeof(rows[i].syscwRate), "%.0f", proc.syscwRate);
+        } else {
+            strcpy(rows[i].readRate, "-");
+            strcpy(rows[i].writeRate, "-");
+            strcpy(rows[i].syscrRate, "-");
+            strcpy(rows[i].syscwRate, "-");
+        }
+    }
+}
+
+// Lowercase ASCII text into `out`, reusing its buffer
+static void toLower(const string& text, string& out) {
+    out.resize(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        out[i] = static_cast<char>(tolower(static_cast<unsigned char>(text[i])));
+    }
+}
+
+// Fill the search index entry of a process, lowercased once per scan instead of on every keystroke
+void buildProcessSearch(const ProcSlot& slot, ProcSearchText& search) {
+    toLower(slot.name, search.name);
+    search.cmdline = slot.cmdline;
+    toLower(getUserName(slot.uid), search.user);
+}
+
+// Parse the search box. Everything is matched case-insensitively.
+//   firefox 12         rows whose name, PID or command line contain both words
+//   user:root          rows owned by a user whose name contains "root"
+//   state:R            rows in state R
+//   re:^kworker/[0-9]  rows whose name or command line match the regex
+void parseProcQuery(const char* input, ProcQuery& query) {
+    query.words.clear();
+    query.user.clear();
+    query.state.clear();
+    query.hasRegex = false;
+    query.regexValid = true;
+
+    string token;
+    const char* p = input;
+    while (*p != '\0') {
+        while (*p == ' ') p++;
+        const char* start = p;
+        while (*p != '\0' && *p != ' ') p++;
+        if (p == start) break;
+        token.assign(start, p - start);
+
+        if (token.compare(0, 3, "re:") == 0) {
+            // the regex takes the rest of the line, spaces included
+            string expression(start + 3);
+            query.hasRegex = true;
+            try {
+                query.pattern.assign(expression, regex::icase | regex::optimize);
+            } catch (const regex_error&) {
+                query.regexValid = false;
             }
-            memValues[key] = value;
+            break;
         }
-        
+
+        string lower;
+        toLower(token, lower);
+        if (lower.compare(0, 5, "user:") == 0) {
+            query.user = lower.substr(5);
+        } else if (token.compare(0, 6, "state:") == 0) {
+            query.state = token.substr(6);  // states are case-sensitive: 'T' stopped, 't' traced
+        } else {
+            query.words.push_back(lower);
+        }
+    }
+}
+
+// True if every process matching `next` also matches `previous`, so `next` can be applied
+// to the rows `previous` matched. Typing longer text is not enough: "state" is a word until
+// the ':' arrives, and "state:RS" matches more than "state:R"
+bool narrowsProcQuery(const ProcQuery& previous, const ProcQuery& next) {
+    if (previous.hasRegex || next.hasRegex) return false;
+    if (previous.user != next.user || previous.state != next.state) return false;
+    if (next.words.size() < previous.words.size()) return false;
+    for (size_t i = 0; i < previous.words.size(); i++) {
+        if (next.words[i].find(previous.words[i]) == string::npos) return false;
+    }
+    return true;
+}
+
+// Check one process against a parsed query
+bool matchProcess(const ProcQuery& query, const Proc& proc, const ProcRowText& text,
+                  const ProcSearchText& search) {
+    if (!query.state.empty() && query.state.find(proc.state) == string::npos) return false;
+    if (!query.user.empty() && search.user.find(query.user) == string::npos) return false;
+    for (const auto& word : query.words) {
+        if (search.name.find(word) == string::npos &&
+            search.cmdline.find(word) == string::npos &&
+            strstr(text.pid, word.c_str()) == nullptr) {
+            return false;
+        }
+    }
+    if (query.hasRegex) {
+        if (!query.regexValid) return false;
+        if (!regex_search(search.name, query.pattern) && !regex_search(search.cmdline, query.pattern)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sort `rows` (indices into `processes`) by a ProcColumn. The first `sortedCount`
+// rows must already be in order; this extends the sorted prefix to `wantCount`
+// rows with a partial sort, so finding the top few processes never sorts them all.
+// Returns the new length of the sorted prefix.
+size_t sortProcessRows(vector<int>& rows, const vector<Proc>& processes, int column, bool descending,
+                       size_t sortedCount, size_t wantCount) {
+    wantCount = min(wantCount, rows.size());
+    if (sortedCount >= wantCount) return sortedCount;
+
+    auto less = [&](int a, int b) {
+        const Proc& pa = processes[a];
+        const Proc& pb = processes[b];
+        int order = 0;
+        switch (column) {
+            case PROC_COLUMN_NAME: order = pa.name.compare(pb.name); break;
+            case PROC_COLUMN_STATE: order = pa.state - pb.state; break;
+            case PROC_COLUMN_CPU: order = (pa.cpuPercent > pb.cpuPercent) - (pa.cpuPercent < pb.cpuPercent); break;
+            case PROC_COLUMN_MEMORY: order = (pa.rss > pb.rss) - (pa.rss < pb.rss); break;
+            case PROC_COLUMN_READ: order = (pa.readRate > pb.readRate) - (pa.readRate < pb.readRate); break;
+            case PROC_COLUMN_WRITE: order = (pa.writeRate > pb.writeRate) - (pa.writeRate < pb.writeRate); break;
+            case PROC_COLUMN_SYSCR: order = (pa.syscrRate > pb.syscrRate) - (pa.syscrRate < pb.syscrRate); break;
+            case PROC_COLUMN_SYSCW: order = (pa.syscwRate > pb.syscwRate) - (pa.syscwRate < pb.syscwRate); break;
+            default: break;
+        }
+        if (order == 0) order = pa.pid - pb.pid;  // ties keep PID order so rows do not flicker
+        return descending ? order > 0 : order < 0;
+    };
+
+    if (wantCount == rows.size()) {
+        sort(rows.begin() + sortedCount, rows.end(), less);
+    } else {
+        partial_sort(rows.begin() + sortedCount, rows.begin() + wantCount, rows.end(), less);
+    }
+    return wantCount;
+}
+
+static const size_t PROCESS_TABLE_MIN_CAPACITY = 1024;
+
+ProcessTable::ProcessTable()
+    : slots(PROCESS_TABLE_MIN_CAPACITY), count(0), shift(64 - 10),
+      generation(0), scanTime(0.0), lastScanTime(0.0),
+      ticksPerSecond(sysconf(_SC_CLK_TCK)),
+      procFd(open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {
+    if (ticksPerSecond <= 0) ticksPerSecond = 100;
+    for (auto& slot : slots) slot.pid = 0;
+}
+
+ProcessTable::~ProcessTable() {
+    if (procFd >= 0) close(procFd);
+}
+
+// Fibonacci hashing, spreads sequential PIDs over the whole table
+size_t ProcessTable::home(int pid) const {
+    return static_cast<size_t>((static_cast<uint64_t>(pid) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+// Index of `pid`, or of the empty slot where it would go
+size_t ProcessTable::find(int pid) const {
+    size_t mask = slots.size() - 1;
+    size_t index = home(pid);
+    while (slots[index].pid != 0 && slots[index].pid != pid) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// Double the capacity and reinsert every live slot
+void ProcessTable::grow() {
+    vector<ProcSlot> old(slots.size() * 2);
+    old.swap(slots);
+    for (auto& slot : slots) slot.pid = 0;
+    shift--;
+    for (auto& slot : old) {
+        if (slot.pid != 0) {
+            slots[find(slot.pid)] = std::move(slot);
+        }
+    }
+}
+
+// Remove a slot with backward-shift deletion, so lookups never need tombstones
+void ProcessTable::erase(size_t index) {
+    size_t mask = slots.size() - 1;
+    size_t hole = index;
+    size_t next = (index + 1) & mask;
+    while (slots[next].pid != 0) {
+        // move the entry back unless its home lies cyclically in (hole, next]
+        size_t h = home(slots[next].pid);
+        if (((next - h) & mask) >= ((next - hole) & mask)) {
+            slots[hole] = std::move(slots[next]);
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    slots[hole].pid = 0;
+    count--;
+}
+
+// Start a new scan generation, `now` is the monotonic time the scan started
+void ProcessTable::beginScan(double now) {
+    generation++;
+    lastScanTime = scanTime;
+    scanTime = now;
+}
+
+// Read the owner and command line of a process, only done when a PID is first
+// seen or its name changes, since the scan itself never needs them
+static void readProcDetails(int procFd, const char* pid, ProcSlot& slot) {
+    struct stat st;
+    slot.uid = (fstatat(procFd, pid, &st, 0) == 0) ? st.st_uid : 0;
+
+    slot.cmdline.clear();
+    char path[32];
+    snprintf(path, sizeof(path), "%s/cmdline", pid);
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    char buf[512];  // long command lines are cut off, the start is what people search for
+    ssize_t len = read(fd, buf, sizeof(buf));
+    close(fd);
+    for (ssize_t i = 0; i < len; i++) {
+        // arguments are separated by '\0'
+        slot.cmdline += buf[i] == '\0' ? ' ' : static_cast<char>(tolower(static_cast<unsigned char>(buf[i])));
+    }
+    while (!slot.cmdline.empty() && slot.cmdline.back() == ' ') slot.cmdline.pop_back();
+}
+
+// Read /proc/[pid]/io. Other users' processes are refused with EACCES unless we
+// could ptrace them; that is remembered in `readable` so they are not retried every scan
+static bool readProcIO(int procFd, const char* pid, ProcIO& io, bool& readable) {
+    char path[32];
+    snprintf(path, sizeof(path), "%s/io", pid);
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == EACCES || errno == EPERM) readable = false;
+        return false;  // or the process exited since readdir
+    }
+    char buf[256];
+    ssize_t len = read(fd, buf, sizeof(buf));
+    int error = errno;
+    close(fd);
+    if (len < 0 && (error == EACCES || error == EPERM)) readable = false;  // checked at read time on some kernels
+    return len > 0 && parseProcIO(buf, static_cast<size_t>(len), io);
+}
+
+// Record a process seen by the current scan and calculate its CPU percentage,
+// where 100% is one core fully busy over the time between the two scans, and
+// its disk I/O rates over the same time.
+// The returned slot is only valid until the next update().
+const ProcSlot& ProcessTable::update(const Proc& proc) {
+    if ((count + 1) * 2 > slots.size()) grow();  // keep the load factor under 0.5
+
+    size_t index = find(proc.pid);
+    ProcSlot& slot = slots[index];
+    slot.cpuPercent = 0.0f;
+    slot.readRate = slot.writeRate = slot.syscrRate = slot.syscwRate = 0.0f;
+    bool hadIO = slot.pid == proc.pid && slot.startTime == proc.startTime && slot.hasIO;
+    char pid[16];
+    snprintf(pid, sizeof(pid), "%d", proc.pid);
+
+    if (slot.pid == 0 || slot.startTime != proc.startTime) {
+        // new process, or a new process that reused the PID
+        if (slot.pid == 0) count++;
+        slot.pid = proc.pid;
+        slot.startTime = proc.startTime;
+        slot.name = proc.name;
+        slot.ioReadable = true;
+        readProcDetails(procFd, pid, slot);
+    } else {
+        if (slot.name != proc.name) {
+            // the process called exec, or renamed itself
+            slot.name = proc.name;
+            slot.ioReadable = true;   // a setuid exec changes who may read its I/O
+            readProcDetails(procFd, pid, slot);
+        }
+        if (scanTime > lastScanTime) {
+            long long int ticks = (proc.utime - slot.prevUtime) + (proc.stime - slot.prevStime);
+            double seconds = static_cast<double>(ticks) / ticksPerSecond;
+            slot.cpuPercent = static_cast<float>(seconds / (scanTime - lastScanTime) * 100.0);
+        }
+    }
+
+    ProcIO io;
+    slot.hasIO = slot.ioReadable && readProcIO(procFd, pid, io, slot.ioReadable);
+    if (slot.hasIO) {
+        if (hadIO && scanTime > lastScanTime) {
+            double seconds = scanTime - lastScanTime;
+            auto rate = [seconds](uint64_t value, uint64_t previous) {
+                return value >= previous ? static_cast<float>((value - previous) / seconds) : 0.0f;
+            };
+            slot.readRate = rate(io.readBytes, slot.io.readBytes);
+            slot.writeRate = rate(io.writeBytes, slot.io.writeBytes);
+            slot.syscrRate = rate(io.syscr, slot.io.syscr);
+            slot.syscwRate = rate(io.syscw, slot.io.syscw);
+        }
+        slot.io = io;
+    }
+
+    slot.prevUtime = proc.utime;
+    slot.prevStime = proc.stime;
+    slot.generation = generation;
+    return slot;
+}
+
+// Evict every PID the current scan did not see
+void ProcessTable::endScan() {
+    size_t index = 0;
+    while (index < slots.size()) {
+        if (slots[index].pid != 0 && slots[index].generation != generation) {
+            erase(index);  // a later entry may have moved into `index`, check it again
+        } else {
+            index++;
+        }
+    }
+}
+
+// /proc/meminfo keys, looked up through a perfect hash built at compile time:
+// the seed is searched until every key lands in its own slot, so a lookup is one
+// hash, one slot load and one compare against the key it must be
+struct MemInfoKey {
+    const char* name;
+    uint64_t ProcMemInfo::*field;
+};
+
+static constexpr MemInfoKey memInfoKeys[] = {
+    { "MemTotal", &ProcMemInfo::memTotal },
+    { "MemFree", &ProcMemInfo::memFree },
+    { "MemAvailable", &ProcMemInfo::memAvailable },
+    { "Buffers", &ProcMemInfo::buffers },
+    { "Cached", &ProcMemInfo::cached },
+    { "SwapCached", &ProcMemInfo::swapCached },
+    { "Active", &ProcMemInfo::active },
+    { "Inactive", &ProcMemInfo::inactive },
+    { "Active(anon)", &ProcMemInfo::activeAnon },
+    { "Inactive(anon)", &ProcMemInfo::inactiveAnon },
+    { "Active(file)", &ProcMemInfo::activeFile },
+    { "Inactive(file)", &ProcMemInfo::inactiveFile },
+    { "Unevictable", &ProcMemInfo::unevictable },
+    { "Mlocked", &ProcMemInfo::mlocked },
+    { "SwapTotal", &ProcMemInfo::swapTotal },
+    { "SwapFree", &ProcMemInfo::swapFree },
+    { "Zswap", &ProcMemInfo::zswap },
+    { "Zswapped", &ProcMemInfo::zswapped },
+    { "Dirty", &ProcMemInfo::dirty },
+    { "Writeback", &ProcMemInfo::writeback },
+    { "AnonPages", &ProcMemInfo::anonPages },
+    { "Mapped", &ProcMemInfo::mapped },
+    { "Shmem", &ProcMemInfo::shmem },
+    { "KReclaimable", &ProcMemInfo::kReclaimable },
+    { "Slab", &ProcMemInfo::slab },
+    { "SReclaimable", &ProcMemInfo::sReclaimable },
+    { "SUnreclaim", &ProcMemInfo::sUnreclaim },
+    { "KernelStack", &ProcMemInfo::kernelStack },
+    { "PageTables", &ProcMemInfo::pageTables },
+    { "SecPageTables", &ProcMemInfo::secPageTables },
+    { "NFS_Unstable", &ProcMemInfo::nfsUnstable },
+    { "Bounce", &ProcMemInfo::bounce },
+    { "WritebackTmp", &ProcMemInfo::writebackTmp },
+    { "CommitLimit", &ProcMemInfo::commitLimit },
+    { "Committed_AS", &ProcMemInfo::committedAS },
+    { "VmallocTotal", &ProcMemInfo::vmallocTotal },
+    { "VmallocUsed", &ProcMemInfo::vmallocUsed },
+    { "VmallocChunk", &ProcMemInfo::vmallocChunk },
+    { "Percpu", &ProcMemInfo::percpu },
+    { "HardwareCorrupted", &ProcMemInfo::hardwareCorrupted },
+    { "AnonHugePages", &ProcMemInfo::anonHugePages },
+    { "ShmemHugePages", &ProcMemInfo::shmemHugePages },
+    { "ShmemPmdMapped", &ProcMemInfo::shmemPmdMapped },
+    { "FileHugePages", &ProcMemInfo::fileHugePages },
+    { "FilePmdMapped", &ProcMemInfo::filePmdMapped },
+    { "CmaTotal", &ProcMemInfo::cmaTotal },
+    { "CmaFree", &ProcMemInfo::cmaFree },
+    { "Balloon", &ProcMemInfo::balloon },
+    { "Unaccepted", &ProcMemInfo::unaccepted },
+    { "HugePages_Total", &ProcMemInfo::hugePagesTotal },
+    { "HugePages_Free", &ProcMemInfo::hugePagesFree },
+    { "HugePages_Rsvd", &ProcMemInfo::hugePagesRsvd },
+    { "HugePages_Surp", &ProcMemInfo::hugePagesSurp },
+    { "Hugepagesize", &ProcMemInfo::hugepageSize },
+    { "Hugetlb", &ProcMemInfo::hugetlb },
+    { "DirectMap4k", &ProcMemInfo::directMap4k },
+    { "DirectMap2M", &ProcMemInfo::directMap2M },
+    { "DirectMap4M", &ProcMemInfo::directMap4M },
+    { "DirectMap1G", &ProcMemInfo::directMap1G },
+};
+
+static const int MEMINFO_KEYS = sizeof(memInfoKeys) / sizeof(memInfoKeys[0]);
+static const uint32_t MEMINFO_SLOTS = 512;
+static const uint8_t MEMINFO_EMPTY = 0xff;
+
+static constexpr size_t memInfoKeyLength(const char* key) {
+    size_t len = 0;
+    while (key[len] != '\0') len++;
+    return len;
+}
+
+// FNV-1a, seeded
+static constexpr uint32_t memInfoHash(uint32_t seed, const char* key, size_t len) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ static_cast<uint8_t>(key[i])) * 16777619u;
+    }
+    return hash & (MEMINFO_SLOTS - 1);
+}
+
+struct MemInfoTable {
+    uint32_t seed;
+    uint8_t slots[MEMINFO_SLOTS];   // index into memInfoKeys, or MEMINFO_EMPTY
+};
+
+static constexpr MemInfoTable buildMemInfoTable() {
+    for (uint32_t seed = 1; seed < 100000; seed++) {
+        MemInfoTable table = { seed, {} };
+        for (uint32_t i = 0; i < MEMINFO_SLOTS; i++) table.slots[i] = MEMINFO_EMPTY;
+        bool perfect = true;
+        for (int k = 0; k < MEMINFO_KEYS && perfect; k++) {
+            const char* name = memInfoKeys[k].name;
+            uint32_t slot = memInfoHash(seed, name, memInfoKeyLength(name));
+            perfect = table.slots[slot] == MEMINFO_EMPTY;
+            table.slots[slot] = static_cast<uint8_t>(k);
+        }
+        if (perfect) return table;
+    }
+    return { 0, {} };
+}
+
+static constexpr MemInfoTable memInfoTable = buildMemInfoTable();
+static_assert(memInfoTable.seed != 0, "no perfect hash seed for the /proc/meminfo keys");
+static_assert(MEMINFO_KEYS < MEMINFO_EMPTY, "too many /proc/meminfo keys for 8-bit slots");
+
+// Parse /proc/meminfo into `info`. Keys this table doesn't know are skipped, known keys
+// the kernel doesn't print are left as they were
+bool parseMemInfo(const char* buf, size_t len, ProcMemInfo& info) {
+    const char* end = buf + len;
+    const char* p = buf;
+    bool found = false;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* colon = static_cast<const char*>(memchr(p, ':', lineEnd - p));
+        if (colon) {
+            size_t keyLen = colon - p;
+            const MemInfoKey* key = nullptr;
+            uint8_t index = memInfoTable.slots[memInfoHash(memInfoTable.seed, p, keyLen)];
+            if (index != MEMINFO_EMPTY) key = &memInfoKeys[index];
+            if (key && strncmp(key->name, p, keyLen) == 0 && key->name[keyLen] == '\0') {
+                const char* value = colon + 1;
+                info.*key->field = static_cast<uint64_t>(parseStatField(value, lineEnd));
+                found = true;
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return found;
+}
+
+// Read /proc/meminfo with one pread on a descriptor kept open between refreshes.
+// It is about 1.5 KB, so a fixed buffer is plenty and nothing is allocated
+bool readMemInfo(ProcMemInfo& info) {
+    static int fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    static char buf[8192];
+    if (fd < 0) return false;
+    ssize_t len = pread(fd, buf, sizeof(buf), 0);
+    if (len <= 0) return false;
+    return parseMemInfo(buf, static_cast<size_t>(len), info);
+}
+
+// Alternative method to get memory information using /proc/meminfo
+MemoryInfo getMemoryInfoFromProc() {
+    MemoryInfo info = {};
+    ProcMemInfo mem = {};
+    if (readMemInfo(mem)) {
         // Convert KB to bytes
         const uint64_t KB_TO_BYTES = 1024;
         
-        // Total RAM = MemTotal
-        info.totalRam = memValues["MemTotal"] * KB_TO_BYTES;
-        
-        // Free RAM = MemFree + Buffers + Cached + SReclaimable
-        info.freeRam = (memValues["MemFree"] + 
-                       memValues["Buffers"] + 
-                       memValues["Cached"] + 
-                       memValues["SReclaimable"]) * KB_TO_BYTES;
-        
-        // Used RAM = Total - Free
-        info.usedRam = info.totalRam - info.freeRam;
+        info.totalRam = mem.memTotal * KB_TO_BYTES;
+        info.freeRam = mem.memFree * KB_TO_BYTES;
+        info.buffers = mem.buffers * KB_TO_BYTES;
+        info.cached = mem.cached * KB_TO_BYTES;
+        info.sReclaimable = mem.sReclaimable * KB_TO_BYTES;
+        info.shmem = mem.shmem * KB_TO_BYTES;
+        info.dirty = mem.dirty * KB_TO_BYTES;
+        info.writeback = mem.writeback * KB_TO_BYTES;
+        info.anonPages = mem.anonPages * KB_TO_BYTES;
+        info.mapped = mem.mapped * KB_TO_BYTES;
+        info.slab = mem.slab * KB_TO_BYTES;
+        info.hugePagesTotal = mem.hugePagesTotal * mem.hugepageSize * KB_TO_BYTES;
+        info.hugePagesFree = mem.hugePagesFree * mem.hugepageSize * KB_TO_BYTES;
+
+        // MemAvailable is the kernel's own estimate (Linux 3.14+). Before it existed the
+        // usual approximation was free + buffers + page cache + reclaimable slab, minus
+        // shmem, which sits in the page cache but can't be dropped
+        if (mem.memAvailable > 0) {
+            info.availableRam = mem.memAvailable * KB_TO_BYTES;
+        } else {
+            uint64_t reclaimable = mem.memFree + mem.buffers + mem.cached + mem.sReclaimable;
+            info.availableRam = (reclaimable > mem.shmem ? reclaimable - mem.shmem : 0) * KB_TO_BYTES;
+        }
+        info.availableRam = min(info.availableRam, info.totalRam);
+        info.usedRam = info.totalRam - info.availableRam;
         
         // SWAP information
-        info.totalSwap = memValues["SwapTotal"] * KB_TO_BYTES;
-        info.freeSwap = memValues["SwapFree"] * KB_TO_BYTES;
+        info.totalSwap = mem.swapTotal * KB_TO_BYTES;
+        info.freeSwap = mem.swapFree * KB_TO_BYTES;
         info.usedSwap = info.totalSwap - info.freeSwap;
     }
     return info;
@@ -197,10 +752,6 @@ MemoryInfo getMemoryInfoFromProc() {
 // Get memory usage percentage using the new method
 float getMemoryUsagePercentageFromProc(const MemoryInfo& info) {
     if (info.totalRam == 0) return 0.0f;
-    
-    // Calculate actual memory usage excluding buffers and cache
-    uint64_t actualUsed = info.totalRam - (info.freeRam - 
-                         (info.usedRam - (info.totalRam - info.freeRam)));
-    
-    return (static_cast<float>(actualUsed) / info.totalRam) * 100.0f;
+    // used already leaves out everything reclaimable: buffers, cache and reclaimable slab
+    return (static_cast<float>(info.usedRam) / info.totalRam) * 100.0f;
 }
@@ -1,5 +1,15 @@
 #include "header.h"
-
+// open/read for /proc/net/dev
+#include <fcntl.h>
+#include <cstring>
+#ifdef __linux__
+// rtnetlink collector
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <cerrno>
+#endif
 
 
 // Convert bytes to human readable format
@@ -19,13 +29,13 @@ string formatBytes(uint64_t bytes) {
     return string(buffer);
 }
 
-// Get network interfaces and their IPv4 addresses
-vector<pair<string, string>> getNetworkInterfaces() {
-    vector<pair<string, string>> interfaces;
+// Get the IPv4 and IPv6 addresses of every interface with a single getifaddrs() walk
+NetworkAddressMap getNetworkAddresses() {
+    NetworkAddressMap addresses;
     struct ifaddrs *ifaddr, *ifa;
     
     if (getifaddrs(&ifaddr) == -1) {
-        return interfaces;
+        return addresses;
     }
     
     for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
@@ -35,30 +45,38 @@ vector<pair<string, string>> getNetworkInterfaces() {
             char ip[INET_ADDRSTRLEN];
             void *addr = &((struct sockaddr_in *)ifa->ifa_addr)->sin_addr;
             inet_ntop(AF_INET, addr, ip, INET_ADDRSTRLEN);
-            interfaces.push_back({ifa->ifa_name, ip});
+            addresses[ifa->ifa_name].ipv4.push_back(ip);
+        } else if (ifa->ifa_addr->sa_family == AF_INET6) {
+            char ip[INET6_ADDRSTRLEN];
+            void *addr = &((struct sockaddr_in6 *)ifa->ifa_addr)->sin6_addr;
+            inet_ntop(AF_INET6, addr, ip, INET6_ADDRSTRLEN);
+            addresses[ifa->ifa_name].ipv6.push_back(ip);
         }
     }
     
     freeifaddrs(ifaddr);
-    return interfaces;
+    return addresses;
+}
+
+// Copy the addresses of `stats.interface` out of a map built once per refresh
+static void setAddresses(NetworkStats& stats, const NetworkAddressMap& addresses) {
+    auto it = addresses.find(stats.interface);
+    if (it == addresses.end()) return;
+    stats.addresses = it->second;
+    if (!it->second.ipv4.empty()) {
+        stats.ipv4 = it->second.ipv4.front();
+    }
 }
 
-// Get network statistics for an interface
-NetworkStats getNetworkStats(const string& interface) {
-    NetworkStats stats;
+// Get network statistics for an interface from sysfs
+NetworkStats getNetworkStats(const string& interface, const NetworkAddressMap& addresses) {
+    NetworkStats stats = {};
     stats.interface = interface;
     
     string path = "/sys/class/net/" + interface + "/statistics/";
     ifstream file;
     
-    // Get IPv4 address
-    auto interfaces = getNetworkInterfaces();
-    for (const auto& iface : interfaces) {
-        if (iface.first == interface) {
-            stats.ipv4 = iface.second;
-            break;
-        }
-    }
+    setAddresses(stats, addresses);
     
     // RX stats
     file.open(path + "rx_bytes");
@@ -129,19 +147,294 @@ NetworkStats getNetworkStats(const string& interface) {
     return stats;
 }
 
-// Get all network interfaces statistics
+// Parse the contents of /proc/net/dev, one line per interface after two header lines:
+//   "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast tx_bytes tx_packets errs drop fifo colls carrier compressed"
+bool parseNetDev(const char* buf, size_t len, vector<NetworkStats>& stats) {
+    const char* p = buf;
+    const char* end = buf + len;
+    int line = 0;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (eol == nullptr) eol = end;
+        if (line++ >= 2) {
+            const char* colon = static_cast<const char*>(memchr(p, ':', eol - p));
+            if (colon == nullptr) return false;
+            const char* name = p;
+            while (name < colon && *name == ' ') name++;
+
+            NetworkStats iface = {};
+            iface.interface.assign(name, colon - name);
+            uint64_t* fields[] = {
+                &iface.rx_bytes, &iface.rx_packets, &iface.rx_errs, &iface.rx_drop,
+                &iface.rx_fifo, &iface.rx_frame, &iface.rx_compressed, &iface.rx_multicast,
+                &iface.tx_bytes, &iface.tx_packets, &iface.tx_errs, &iface.tx_drop,
+                &iface.tx_fifo, &iface.tx_colls, &iface.tx_carrier, &iface.tx_compressed,
+            };
+            const char* q = colon + 1;
+            for (uint64_t* field : fields) {
+                while (q < eol && *q == ' ') q++;
+                uint64_t value = 0;
+                while (q < eol && *q >= '0' && *q <= '9') {
+                    value = value * 10 + (*q - '0');
+                    q++;
+                }
+                *field = value;
+            }
+            stats.push_back(iface);
+        }
+        p = eol + 1;
+    }
+    return line >= 2;
+}
+
+// Read every interface's counters from /proc/net/dev in one pass, instead of
+// opening sixteen sysfs files per interface
+static bool readNetDev(vector<NetworkStats>& stats) {
+    static vector<char> buf(16384);  // grows to fit hosts with hundreds of interfaces
+    int fd = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    size_t len = 0;
+    ssize_t n;
+    while ((n = read(fd, buf.data() + len, buf.size() - len)) > 0) {
+        len += n;
+        if (len == buf.size()) buf.resize(buf.size() * 2);
+    }
+    close(fd);
+    if (n < 0) return false;
+    return parseNetDev(buf.data(), len, stats);
+}
+
+static atomic<bool> netlinkEnabled(true);
+
+// Choose between the rtnetlink collector and /proc/net/dev
+void setNetlinkEnabled(bool enabled) {
+    netlinkEnabled = enabled;
+}
+
+#ifdef __linux__
+// Copy one link's 64-bit counters, folded the same way /proc/net/dev prints them
+static void setNetlinkCounters(NetworkStats& stats, const struct rtnl_link_stats64& link) {
+    stats.rx_bytes = link.rx_bytes;
+    stats.rx_packets = link.rx_packets;
+    stats.rx_errs = link.rx_errors;
+    stats.rx_drop = link.rx_dropped + link.rx_missed_errors;
+    stats.rx_fifo = link.rx_fifo_errors;
+    stats.rx_frame = link.rx_length_errors + link.rx_over_errors + link.rx_crc_errors + link.rx_frame_errors;
+    stats.rx_compressed = link.rx_compressed;
+    stats.rx_multicast = link.multicast;
+    stats.tx_bytes = link.tx_bytes;
+    stats.tx_packets = link.tx_packets;
+    stats.tx_errs = link.tx_errors;
+    stats.tx_drop = link.tx_dropped;
+    stats.tx_fifo = link.tx_fifo_errors;
+    stats.tx_colls = link.collisions;
+    stats.tx_carrier = link.tx_carrier_errors + link.tx_aborted_errors + link.tx_window_errors + link.tx_heartbeat_errors;
+    stats.tx_compressed = link.tx_compressed;
+}
+
+// Parse one RTM_NEWLINK message into `stats`, returns false if it has no name or counters
+static bool parseLinkMessage(const struct nlmsghdr* msg, NetworkStats& stats) {
+    const struct ifinfomsg* info = static_cast<const struct ifinfomsg*>(NLMSG_DATA(msg));
+    int len = msg->nlmsg_len - NLMSG_LENGTH(sizeof(*info));
+    bool hasName = false;
+    bool hasStats = false;
+    for (const struct rtattr* attr = IFLA_RTA(info); RTA_OK(attr, len); attr = RTA_NEXT(attr, len)) {
+        if (attr->rta_type == IFLA_IFNAME) {
+            stats.interface = static_cast<const char*>(RTA_DATA(attr));
+            hasName = true;
+        } else if (attr->rta_type == IFLA_STATS64 && RTA_PAYLOAD(attr) >= sizeof(struct rtnl_link_stats64)) {
+            struct rtnl_link_stats64 link;
+            memcpy(&link, RTA_DATA(attr), sizeof(link));  // attributes are only 4-byte aligned
+            setNetlinkCounters(stats, link);
+            hasStats = true;
+        }
+    }
+    return hasName && hasStats;
+}
+
+// Dump every link with its 64-bit counters in a single RTM_GETLINK round-trip
+static bool readNetlinkStats(vector<NetworkStats>& stats) {
+    static int fd = -1;
+    static uint32_t sequence = 0;
+    if (fd < 0) {
+        fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+        if (fd < 0) return false;
+        struct timeval timeout = {1, 0};  // never hang the sampler on a lost reply
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    struct {
+        struct nlmsghdr header;
+        struct ifinfomsg info;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(request.info));
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = ++sequence;
+    request.info.ifi_family = AF_UNSPEC;
+    if (send(fd, &request, request.header.nlmsg_len, 0) < 0) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    static vector<char> buf(32768);
+    while (true) {
+        ssize_t len = recv(fd, buf.data(), buf.size(), 0);
+        if (len <= 0) {
+            // timed out or failed mid-dump, start over with a fresh socket next time
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        int remaining = static_cast<int>(len);
+        for (const struct nlmsghdr* msg = reinterpret_cast<const struct nlmsghdr*>(buf.data());
+             NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+            if (msg->nlmsg_seq != sequence) continue;  // a late reply to an earlier dump
+            if (msg->nlmsg_type == NLMSG_DONE) return true;
+            if (msg->nlmsg_type == NLMSG_ERROR) return false;
+            if (msg->nlmsg_type == RTM_NEWLINK) {
+                NetworkStats iface = {};
+                if (parseLinkMessage(msg, iface)) {
+                    stats.push_back(iface);
+                }
+            }
+        }
+    }
+}
+
+// Open a socket subscribed to link add/remove/change notifications, -1 if unavailable
+int openLinkEventSocket() {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) return -1;
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Read every pending notification, returns true if a link appeared, changed or went away
+bool drainLinkEvents(int fd) {
+    char buf[8192];
+    bool changed = false;
+    ssize_t len;
+    while ((len = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        int remaining = static_cast<int>(len);
+        for (const struct nlmsghdr* msg = reinterpret_cast<const struct nlmsghdr*>(buf);
+             NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+            if (msg->nlmsg_type == RTM_NEWLINK || msg->nlmsg_type == RTM_DELLINK) {
+                changed = true;
+            }
+        }
+    }
+    // ENOBUFS means we missed events while busy, so assume something changed
+    if (len < 0 && errno == ENOBUFS) changed = true;
+    return changed;
+}
+#else
+static bool readNetlinkStats(vector<NetworkStats>&) { return false; }
+int openLinkEventSocket() { return -1; }
+bool drainLinkEvents(int) { return false; }
+#endif
+
+// Get the link speed of an interface in Mbit/s, -1 when unknown (virtual links, link down).
+// The value rarely changes, so it is only re-read from sysfs every few seconds.
+int getLinkSpeed(const string& interface) {
+    static const double SPEED_TTL = 10.0;
+    struct CachedSpeed {
+        int speed;
+        double readAt;
+    };
+    static unordered_map<string, CachedSpeed> cache;
+
+    double now = monotonicSeconds();
+    auto it = cache.find(interface);
+    if (it != cache.end() && now - it->second.readAt < SPEED_TTL) {
+        return it->second.speed;
+    }
+
+    int speed = -1;
+    ifstream file("/sys/class/net/" + interface + "/speed");
+    if (!(file >> speed) || speed <= 0) speed = -1;  // reading fails with EINVAL while the link is down
+
+    // drop interfaces that are long gone, container hosts churn through veth names
+    if (it == cache.end() && cache.size() > 1024) {
+        for (auto old = cache.begin(); old != cache.end();) {
+            old = (now - old->second.readAt > SPEED_TTL * 6) ? cache.erase(old) : std::next(old);
+        }
+    }
+    cache[interface] = {speed, now};
+    return speed;
+}
+
+// Per-second rate of a counter, 0 when the counter went backwards (interface re-created)
+static float counterRate(uint64_t current, uint64_t previous, double seconds) {
+    if (current < previous || seconds <= 0.0) return 0.0f;
+    return static_cast<float>((current - previous) / seconds);
+}
+
+// Turn two consecutive samples into per-second rates, matching interfaces by name
+void computeNetworkRates(vector<NetworkStats>& current, const vector<NetworkStats>& previous) {
+    unordered_map<string, const NetworkStats*> byName;
+    for (const auto& stats : previous) {
+        byName[stats.interface] = &stats;
+    }
+    for (auto& stats : current) {
+        auto it = byName.find(stats.interface);
+        if (it == byName.end()) continue;
+        const NetworkStats& prev = *it->second;
+        double seconds = stats.timestamp - prev.timestamp;
+        stats.rx_bytes_rate = counterRate(stats.rx_bytes, prev.rx_bytes, seconds);
+        stats.tx_bytes_rate = counterRate(stats.tx_bytes, prev.tx_bytes, seconds);
+        stats.rx_packets_rate = counterRate(stats.rx_packets, prev.rx_packets, seconds);
+        stats.tx_packets_rate = counterRate(stats.tx_packets, prev.tx_packets, seconds);
+    }
+}
+
+// Stamp freshly read counters with their addresses, link speed and read time
+static void finishNetworkStats(vector<NetworkStats>& stats, const NetworkAddressMap& addresses, double now) {
+    for (auto& iface : stats) {
+        setAddresses(iface, addresses);
+        iface.timestamp = now;
+        iface.speedMbps = getLinkSpeed(iface.interface);
+    }
+}
+
+// Get all network interfaces statistics, from rtnetlink when enabled and
+// available, otherwise from /proc/net/dev, otherwise from sysfs
 vector<NetworkStats> getAllNetworkStats() {
     vector<NetworkStats> stats;
+    NetworkAddressMap addresses = getNetworkAddresses();
+    double now = monotonicSeconds();
+    if (netlinkEnabled && readNetlinkStats(stats)) {
+        finishNetworkStats(stats, addresses, now);
+        return stats;
+    }
+    stats.clear();
+    if (readNetDev(stats)) {
+        finishNetworkStats(stats, addresses, now);
+        return stats;
+    }
+
+    // No /proc/net/dev (procfs not mounted in this namespace), fall back to sysfs
+    stats.clear();
     DIR* dir = opendir("/sys/class/net");
     if (dir != nullptr) {
         struct dirent* entry;
         while ((entry = readdir(dir)) != nullptr) {
             if (entry->d_name[0] != '.') {
-                stats.push_back(getNetworkStats(entry->d_name));
+                stats.push_back(getNetworkStats(entry->d_name, addresses));
             }
         }
         closedir(dir);
     }
+    finishNetworkStats(stats, addresses, now);
     return stats;
 }
 
@@ -0,0 +1,427 @@
+#include "header.h"
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+// The sampler thread owns every collector in system.cpp, mem.cpp and network.cpp.
+// The UI never reads /proc or /sys itself, it only reads the last published snapshot
+// through a lock-free triple buffer and drains the metric queues, so a slow scan can
+// never hold up a frame.
+
+static const chrono::milliseconds SAMPLE_TICK(100);   // link events and the process refresh check
+static const double SLOW_INTERVAL = 1.0;               // memory, disks and network every second
+static const size_t METRIC_QUEUE_SIZE = 4096;          // a bit over a minute at 60 Hz
+
+static thread samplerThread;
+static mutex samplerMutex;               // serializes startSampler() and stopSampler(), never taken by the UI
+static atomic<bool> samplerRunning(false);
+static int wakeFd = -1;                  // eventfd, written to interrupt the sampler's sleep
+static TripleBuffer<SystemSnapshot> snapshots;
+static ProcessTable processTable;        // only touched by the sampler thread
+static CgroupTree cgroupTree;            // only touched by the sampler thread
+static atomic<int> processIntervalMs(1000);
+static vector<Proc> processScan;         // rows of the latest walk, in /proc order
+static int linkEventFd = -1;             // rtnetlink link notifications, -1 if unavailable
+static int factsWatchFd = -1;            // inotify on os-release, -1 if unavailable
+static vector<NetworkStats> previousNetwork;
+static double lastProcessScan = 0.0;
+
+// CPU, fan and thermal are not part of the snapshot: each one is read at the rate
+// set by its FPS slider and streamed to the UI with the time it was read
+static atomic<int> metricRates[METRIC_COUNT] = {{30}, {30}, {30}};
+static double metricDue[METRIC_COUNT];
+static SampleQueue<MetricSample> metricQueues[METRIC_COUNT] = {
+    SampleQueue<MetricSample>(METRIC_QUEUE_SIZE),
+    SampleQueue<MetricSample>(METRIC_QUEUE_SIZE),
+    SampleQueue<MetricSample>(METRIC_QUEUE_SIZE),
+};
+
+// Per-core breakdowns go to the UI through their own triple buffer, written whenever
+// the CPU metric is sampled, so the heatmap never waits on a slow tick
+static TripleBuffer<CPUSample> cpuSamples;
+static CPUStats cpuTotal[2];             // this and the previous /proc/stat reading
+static vector<CPUStats> cpuCores[2];
+static vector<bool> cpuOnline;
+static int cpuCurrent = 0;
+static uint64_t cpuGeneration = 0;
+static SampleQueue<CPUTimeSample> cpuTimeQueue(METRIC_QUEUE_SIZE);   // aggregate breakdown of every sample
+
+// Read /proc/stat, publish the per-core breakdown and return the aggregate busy percentage
+static float sampleCPU() {
+    int prev = cpuCurrent;
+    cpuCurrent ^= 1;
+    if (!readCPUStats(cpuTotal[cpuCurrent], cpuCores[cpuCurrent], cpuOnline)) {
+        cpuCurrent = prev;
+        return 0.0f;
+    }
+    cpuCores[prev].resize(cpuCores[cpuCurrent].size(), CPUStats());
+
+    CPUSample& sample = cpuSamples.writeBuffer();
+    sample.generation = ++cpuGeneration;
+    sample.time = monotonicSeconds();
+    computeCPUBreakdown(cpuTotal[cpuCurrent], cpuTotal[prev], sample.total);
+    sample.cores.resize(cpuCores[cpuCurrent].size());
+    sample.online = cpuOnline;
+    for (size_t i = 0; i < sample.cores.size(); i++) {
+        computeCPUBreakdown(cpuCores[cpuCurrent][i], cpuCores[prev][i], sample.cores[i]);
+    }
+    cpuTimeQueue.push({ sample.time, sample.total });
+    cpuSamples.publish();
+    return sample.total.busy;
+}
+
+// Fan and temperature sensors are discovered once when the sampler starts. Reading a
+// metric re-reads every sensor of its kind, publishes them all for the Fan and Thermal
+// tables, and graphs the one picked with setGraphSensor()
+static vector<Sensor> sensors;
+static TripleBuffer<SensorSample> sensorSamples;
+static atomic<int> graphSensor[2] = {{-1}, {-1}};
+static uint64_t sensorGeneration = 0;
+
+// Read every sensor of one kind and return the value of the graphed one
+static float sampleSensors(SensorKind kind) {
+    readSensors(sensors, kind);
+
+    SensorSample& sample = sensorSamples.writeBuffer();
+    sample.generation = ++sensorGeneration;
+    sample.sensors.resize(sensors.size());
+    for (size_t i = 0; i < sensors.size(); i++) sample.sensors[i] = sensors[i].reading;
+    sample.graphSensor[SENSOR_TEMPERATURE] = graphSensor[SENSOR_TEMPERATURE];
+    sample.graphSensor[SENSOR_FAN] = graphSensor[SENSOR_FAN];
+    sensorSamples.publish();
+
+    int index = graphSensor[kind];
+    if (index < 0 || index >= static_cast<int>(sensors.size()) || !sensors[index].reading.valid) return 0.0f;
+    return sensors[index].reading.value;
+}
+
+// Read one metric
+static float readMetric(int metric) {
+    switch (metric) {
+    case METRIC_CPU: return sampleCPU();
+    case METRIC_FAN: return sampleSensors(SENSOR_FAN);
+    case METRIC_THERMAL: return sampleSensors(SENSOR_TEMPERATURE);
+    }
+    return 0.0f;
+}
+
+// Read every metric that is due and queue it for the UI, returns when the next one is due
+static double sampleMetrics(double now) {
+    double next = now + chrono::duration<double>(SAMPLE_TICK).count();
+    for (int metric = 0; metric < METRIC_COUNT; metric++) {
+        double period = 1.0 / metricRates[metric];
+        if (metricDue[metric] > now + period) {
+            metricDue[metric] = now;   // the rate went up, don't wait out the old period
+        }
+        if (now >= metricDue[metric]) {
+            MetricSample sample = { monotonicSeconds(), readMetric(metric) };
+            metricQueues[metric].push(sample);   // dropped if the UI is a full queue behind
+            metricDue[metric] += period;
+            if (metricDue[metric] <= now) {
+                metricDue[metric] = now + period;   // after a stall, restart rather than catch up
+            }
+        }
+        next = min(next, metricDue[metric]);
+    }
+    return next;
+}
+
+// Refresh the network counters and turn them into rates against the previous refresh
+static void sampleNetwork(SystemSnapshot& snapshot) {
+    previousNetwork.swap(snapshot.networkStats);
+    snapshot.networkStats = getAllNetworkStats();
+    computeNetworkRates(snapshot.networkStats, previousNetwork);
+    snapshot.networkTime = monotonicSeconds();
+}
+
+// PSI files stay open and are re-read with pread. Triggers on the system-wide files make
+// the sampler wake up as soon as tasks stall, rather than noticing it at the next refresh
+static const uint64_t PRESSURE_TRIGGER_STALL = 150000;     // 150 ms of stall...
+static const uint64_t PRESSURE_TRIGGER_WINDOW = 2000000;   // ...within any 2 s, unprivileged minimum
+static int pressureFds[PRESSURE_COUNT] = { -1, -1, -1 };
+static int cgroupPressureFds[PRESSURE_COUNT] = { -1, -1, -1 };
+static int pressureTriggerFds[PRESSURE_COUNT] = { -1, -1, -1 };
+static mutex pressureCgroupMutex;        // guards requestedPressureCgroup, set by the UI
+static string requestedPressureCgroup;
+static atomic<bool> pressureCgroupChanged(false);
+
+static void closeFds(int* fds, int count) {
+    for (int i = 0; i < count; i++) {
+        if (fds[i] >= 0) close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+// Re-read every PSI file and turn the totals into rates against the previous read
+static void samplePressure(SystemSnapshot& snapshot) {
+    if (pressureCgroupChanged.exchange(false)) {
+        lock_guard<mutex> lock(pressureCgroupMutex);
+        closeFds(cgroupPressureFds, PRESSURE_COUNT);
+        snapshot.pressureCgroup = requestedPressureCgroup;
+        if (!snapshot.pressureCgroup.empty() && !snapshot.cgroupRoot.empty()) {
+            for (int r = 0; r < PRESSURE_COUNT; r++) {
+                cgroupPressureFds[r] = openPressureFile(snapshot.cgroupRoot + "/" + snapshot.pressureCgroup,
+                                                        static_cast<PressureResource>(r), true);
+            }
+        }
+        // don't compute rates against another cgroup's totals
+        for (PressureStats& stats : snapshot.cgroupPressure) stats = PressureStats();
+    }
+
+    double now = monotonicSeconds();
+    double seconds = now - snapshot.pressureTime;
+    for (int r = 0; r < PRESSURE_COUNT; r++) {
+        PressureStats stats;
+        readPressure(pressureFds[r], stats);
+        computePressureRates(stats, snapshot.pressure[r], seconds);
+        snapshot.pressure[r] = stats;
+
+        readPressure(cgroupPressureFds[r], stats);
+        computePressureRates(stats, snapshot.cgroupPressure[r], seconds);
+        snapshot.cgroupPressure[r] = stats;
+    }
+    snapshot.pressureTime = now;
+}
+
+// Read the statistics of every cgroup
+static void sampleCgroups(SystemSnapshot& snapshot) {
+    cgroupTree.refresh(snapshot.cgroups, monotonicSeconds());
+    snapshot.cgroupGeneration++;
+}
+
+// Refresh the collectors that walk /proc and /sys
+static void sampleSlow(SystemSnapshot& snapshot) {
+    snapshot.memInfo = getMemoryInfoFromProc();
+    snapshot.memoryTime = monotonicSeconds();
+    snapshot.diskInfo = getDiskInfo();
+    samplePressure(snapshot);
+    snapshot.pressureTickTime = snapshot.pressureTime;
+    sampleCgroups(snapshot);
+    sampleNetwork(snapshot);
+}
+
+// Walk /proc once, feeding both the process table and the task counts
+static void sampleProcesses(SystemSnapshot& snapshot) {
+    snapshot.processTime = monotonicSeconds();
+    snapshot.cpuCount = getCPUCount();
+    getProcessList(processScan);
+    applyProcessDiff(snapshot.processes, processScan);
+    processTable.beginScan(snapshot.processTime);
+    snapshot.processSearch.resize(snapshot.processes.size());
+    for (size_t i = 0; i < snapshot.processes.size(); i++) {
+        Proc& proc = snapshot.processes[i];
+        const ProcSlot& slot = processTable.update(proc);
+        proc.cpuPercent = slot.cpuPercent;
+        proc.uid = slot.uid;
+        proc.hasIO = slot.hasIO;
+        proc.readRate = slot.readRate;
+        proc.writeRate = slot.writeRate;
+        proc.syscrRate = slot.syscrRate;
+        proc.syscwRate = slot.syscwRate;
+
+        buildProcessSearch(slot, snapshot.processSearch[i]);
+    }
+    processTable.endScan();
+    formatProcessRows(snapshot.processes, snapshot.memInfo, snapshot.cpuCount, snapshot.processText);
+    snapshot.taskStats = getProcessStats(snapshot.processes);
+    snapshot.processGeneration++;
+    lastProcessScan = snapshot.processTime;
+}
+
+static void samplerLoop() {
+    SystemSnapshot snapshot;
+    double start = monotonicSeconds();
+    double nextTick = start;
+    double nextSlow = start;
+    for (int metric = 0; metric < METRIC_COUNT; metric++) metricDue[metric] = start;
+    linkEventFd = openLinkEventSocket();
+    factsWatchFd = openSystemFactsWatch();
+    loadSystemFacts(snapshot.facts);
+    snapshot.cgroupRoot = getCgroupRoot();
+    cgroupTree.open();
+    discoverSensors(sensors);
+    graphSensor[SENSOR_TEMPERATURE] = choosePrimarySensor(sensors, SENSOR_TEMPERATURE);
+    graphSensor[SENSOR_FAN] = choosePrimarySensor(sensors, SENSOR_FAN);
+    for (int r = 0; r < PRESSURE_COUNT; r++) {
+        pressureFds[r] = openPressureFile("/proc/pressure", static_cast<PressureResource>(r), false);
+        pressureTriggerFds[r] = openPressureTrigger(static_cast<PressureResource>(r),
+                                                    PRESSURE_TRIGGER_STALL, PRESSURE_TRIGGER_WINDOW);
+        snapshot.pressureTriggers = snapshot.pressureTriggers || pressureTriggerFds[r] >= 0;
+    }
+
+    // every descriptor that can wake the sampler early
+    enum { WAKE_STOP, WAKE_LINK, WAKE_FACTS, WAKE_PRESSURE };
+    struct pollfd fds[WAKE_PRESSURE + PRESSURE_COUNT];
+    fds[WAKE_STOP] = { wakeFd, POLLIN, 0 };
+    fds[WAKE_LINK] = { linkEventFd, POLLIN, 0 };     // negative descriptors are ignored by poll
+    fds[WAKE_FACTS] = { factsWatchFd, POLLIN, 0 };
+    for (int r = 0; r < PRESSURE_COUNT; r++) fds[WAKE_PRESSURE + r] = { pressureTriggerFds[r], POLLPRI, 0 };
+    bool stalled = false;
+
+    while (samplerRunning) {
+        double now = monotonicSeconds();
+        double nextWake = sampleMetrics(now);
+
+        if (stalled) {
+            // a PSI trigger fired: show the stall now rather than at the next slow tick
+            samplePressure(snapshot);
+            snapshot.pressureEvents++;
+            snapshot.generation++;
+            snapshots.writeBuffer() = snapshot;
+            snapshots.publish();
+            stalled = false;
+        }
+
+        if (now >= nextTick) {
+            bool changed = false;
+            bool cgroupsChanged = cgroupTree.applyEvents();
+            if (now >= nextSlow) {
+                sampleSlow(snapshot);
+                nextSlow = max(nextSlow + SLOW_INTERVAL, now);
+                changed = true;
+            } else {
+                if (linkEventFd >= 0 && drainLinkEvents(linkEventFd)) {
+                    // an interface came or went, show it now rather than at the next slow tick
+                    sampleNetwork(snapshot);
+                    changed = true;
+                }
+                if (cgroupsChanged) {
+                    // same for a container starting or stopping
+                    sampleCgroups(snapshot);
+                    changed = true;
+                }
+            }
+            if (refreshSystemFacts(snapshot.facts, factsWatchFd, now)) {
+                changed = true;
+            }
+            if (snapshot.processGeneration == 0 ||
+                now - lastProcessScan >= processIntervalMs / 1000.0) {
+                sampleProcesses(snapshot);
+                changed = true;
+            }
+
+            // only publish when something changed, so fast metrics never copy the process list
+            if (changed) {
+                snapshot.generation++;
+                // copy-assign so the stale buffer's vectors and strings keep their capacity
+                snapshots.writeBuffer() = snapshot;
+                snapshots.publish();
+            }
+            nextTick = max(nextTick + chrono::duration<double>(SAMPLE_TICK).count(), now);
+        }
+        nextWake = min(nextWake, nextTick);
+
+        double delay = max(0.0, nextWake - monotonicSeconds());
+        struct timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(delay);
+        timeout.tv_nsec = static_cast<long>((delay - timeout.tv_sec) * 1e9);
+        if (ppoll(fds, WAKE_PRESSURE + PRESSURE_COUNT, &timeout, nullptr) > 0) {
+            if (fds[WAKE_STOP].revents) {
+                uint64_t count;
+                ssize_t drained = read(wakeFd, &count, sizeof(count));   // reset the eventfd
+                (void)drained;
+            }
+            // link and os-release events are handled by the housekeeping tick, run it now
+            if (fds[WAKE_LINK].revents || fds[WAKE_FACTS].revents) nextTick = 0.0;
+            for (int r = 0; r < PRESSURE_COUNT; r++) {
+                short events = fds[WAKE_PRESSURE + r].revents;
+                if (events & POLLPRI) stalled = true;
+                if (events & (POLLERR | POLLNVAL)) fds[WAKE_PRESSURE + r].fd = -1;
+            }
+        }
+    }
+
+    if (linkEventFd >= 0) {
+        close(linkEventFd);
+        linkEventFd = -1;
+    }
+    if (factsWatchFd >= 0) {
+        close(factsWatchFd);
+        factsWatchFd = -1;
+    }
+    closeSensors(sensors);
+    cgroupTree.close();
+    closeFds(pressureFds, PRESSURE_COUNT);
+    closeFds(cgroupPressureFds, PRESSURE_COUNT);
+    closeFds(pressureTriggerFds, PRESSURE_COUNT);
+}
+
+// Start the background sampler, safe to call more than once
+void startSampler() {
+    lock_guard<mutex> lock(samplerMutex);
+    if (samplerRunning) return;
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    samplerRunning = true;
+    samplerThread = thread(samplerLoop);
+}
+
+// Stop the background sampler and wait for the current tick to finish
+void stopSampler() {
+    lock_guard<mutex> lock(samplerMutex);
+    if (!samplerRunning) return;
+    samplerRunning = false;
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));   // interrupt the sampler's ppoll
+    (void)written;
+    samplerThread.join();
+    close(wakeFd);
+    wakeFd = -1;
+}
+
+// Choose the cgroup whose PSI files are shown next to the system-wide ones, relative
+// to getCgroupRoot(); empty for none. Takes effect at the next pressure refresh
+void setPressureCgroup(const string& path) {
+    lock_guard<mutex> lock(pressureCgroupMutex);
+    requestedPressureCgroup = path;
+    pressureCgroupChanged = true;
+}
+
+// Set how often the process list is rescanned, in milliseconds
+void setProcessRefreshInterval(int ms) {
+    processIntervalMs = max(ms, (int)SAMPLE_TICK.count());
+}
+
+// Set how many times per second a metric is read, from the System window's FPS sliders
+void setMetricRate(Metric metric, int hz) {
+    metricRates[metric] = max(1, min(hz, 1000));
+}
+
+// Pop the oldest queued sample of a metric, called by the UI until it returns false
+bool popMetricSample(Metric metric, MetricSample& sample) {
+    return metricQueues[metric].pop(sample);
+}
+
+// Pop the oldest queued CPU time breakdown, called by the UI until it returns false
+bool popCPUTimeSample(CPUTimeSample& sample) {
+    return cpuTimeQueue.pop(sample);
+}
+
+// Choose which sensor of a kind feeds its graph, an index into SensorSample::sensors
+void setGraphSensor(SensorKind kind, int index) {
+    graphSensor[kind] = index;
+}
+
+// Pick up the newest published snapshot, called once per frame by the render loop
+// so every window draws from the same generation
+bool updateSnapshot() {
+    cpuSamples.update();
+    sensorSamples.update();
+    return snapshots.update();
+}
+
+// Get the snapshot picked up by the last updateSnapshot(), generation 0 until the first tick completes
+const SystemSnapshot& getLatestSnapshot() {
+    return snapshots.read();
+}
+
+// Get the per-core CPU sample picked up by the last updateSnapshot()
+const CPUSample& getLatestCPUSample() {
+    return cpuSamples.read();
+}
+
+// Get the sensor values picked up by the last updateSnapshot()
+const SensorSample& getLatestSensorSample() {
+    return sensorSamples.read();
+}
@@ -1,5 +1,17 @@
 #include "header.h"
 #include <sstream>  // Add this for stringstream
+#include <unordered_map>
+// user names for the process search
+#include <pwd.h>
+// /proc/stat through a descriptor kept open between reads
+#include <fcntl.h>
+#include <cstring>
+#include <algorithm>
+// change notifications for the system facts
+#include <sys/utsname.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 
 // get cpu id and information, you can use `proc/cpuinfo`
 string CPUinfo()
@@ -84,6 +96,25 @@ string getDetailedOSInfo() {
     return osInfo;
 }
 
+// Get the name of a user, looked up once per uid
+string getUserName(uid_t uid) {
+    static unordered_map<uid_t, string> names;
+    auto it = names.find(uid);
+    if (it != names.end()) return it->second;
+
+    struct passwd pwd;
+    struct passwd* result = nullptr;
+    char buf[1024];
+    string name;
+    if (getpwuid_r(uid, &pwd, buf, sizeof(buf), &result) == 0 && result != nullptr) {
+        name = pwd.pw_name;
+    } else {
+        name = to_string(uid);
+    }
+    names[uid] = name;
+    return name;
+}
+
 // Get the computer hostname
 string getHostname() {
     char hostname[HOST_NAME_MAX];
@@ -93,62 +124,186 @@ string getHostname() {
     return "Unknown";
 }
 
-// Cache for process stats
-static TaskStats cachedStats = {0, 0, 0, 0, 0, 0};
-static time_t lastUpdate = 0;
+// How often the hostname is polled; there is no notification for sethostname()
+static const double HOSTNAME_POLL_INTERVAL = 5.0;
 
-// Get task statistics from /proc/stat
-TaskStats getProcessStats() {
-    time_t currentTime = time(nullptr);
-    
-    // Update stats only every 2 seconds
-    if (currentTime - lastUpdate >= 2) {
-        TaskStats stats = {0, 0, 0, 0, 0, 0};
-        DIR* procDir = opendir("/proc");
-        if (procDir != nullptr) {
-            struct dirent* entry;
-            while ((entry = readdir(procDir)) != nullptr) {
-                if (isdigit(entry->d_name[0])) {
-                    string statPath = "/proc/" + string(entry->d_name) + "/stat";
-                    ifstream statFile(statPath);
-                    if (statFile.is_open()) {
-                        string line;
-                        getline(statFile, line);
-                        stringstream ss(line);
-                        string state;
-                        // Skip PID and comm
-                        ss >> state >> state;
-                        // Get state
-                        ss >> state;
-                        stats.total++;
-                        switch(state[0]) {
-                            case 'R': stats.running++; break;
-                            case 'S': 
-                            case 'I': stats.sleeping++; break;  // 'I' is idle (sleeping)
-                            case 'D': stats.uninterruptible++; break;
-                            case 'Z': stats.zombie++; break;
-                            case 'T': 
-                            case 't': stats.traced++; break;    // 't' is traced
-                            default: stats.sleeping++; break;   // Other states count as sleeping
-                        }
-                    }
-                }
+// Read every system fact once, at startup
+void loadSystemFacts(SystemFacts& facts) {
+    facts.osInfo = getDetailedOSInfo();
+    facts.hostname = getHostname();
+    facts.loggedInUser = getLoggedInUser();
+
+    // the cpuid brand string is padded with spaces on some CPUs
+    facts.cpuModel = CPUinfo();
+    size_t first = facts.cpuModel.find_first_not_of(' ');
+    size_t last = facts.cpuModel.find_last_not_of(' ');
+    facts.cpuModel = first == string::npos ? "Unknown" : facts.cpuModel.substr(first, last - first + 1);
+}
+
+// Watch the directories holding os-release for the file being rewritten or replaced.
+// /etc/os-release is usually a symlink to /usr/lib/os-release, which package upgrades
+// replace by rename, so the file itself can't be watched. Returns -1 without inotify
+int openSystemFactsWatch() {
+#ifdef __linux__
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return -1;
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+    bool watching = inotify_add_watch(fd, "/etc", mask) >= 0;
+    watching = inotify_add_watch(fd, "/usr/lib", mask) >= 0 || watching;
+    if (!watching) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+// Apply pending os-release notifications and poll the hostname when it is due.
+// Returns true if a fact changed
+bool refreshSystemFacts(SystemFacts& facts, int watchFd, double now) {
+    static double lastHostnamePoll = 0.0;
+    bool changed = false;
+
+#ifdef __linux__
+    if (watchFd >= 0) {
+        bool osReleaseChanged = false;
+        alignas(struct inotify_event) char buf[4096];
+        ssize_t len;
+        while ((len = read(watchFd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + len; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+                if (event->len > 0 && strcmp(event->name, "os-release") == 0) osReleaseChanged = true;
+                p += sizeof(struct inotify_event) + event->len;
             }
-            closedir(procDir);
-            
-            // Verify total matches sum of states
-            int sum = stats.running + stats.sleeping + stats.uninterruptible + 
-                     stats.zombie + stats.traced;
-            if (sum != stats.total) {
-                // Adjust total to match sum if there's a discrepancy
-                stats.total = sum;
+        }
+        if (osReleaseChanged) {
+            string osInfo = getDetailedOSInfo();
+            if (osInfo != facts.osInfo) {
+                facts.osInfo = osInfo;
+                changed = true;
             }
         }
-        cachedStats = stats;
-        lastUpdate = currentTime;
     }
-    
-    return cachedStats;
+#endif
+
+    if (now - lastHostnamePoll >= HOSTNAME_POLL_INTERVAL) {
+        lastHostnamePoll = now;
+        struct utsname name;
+        if (uname(&name) == 0 && facts.hostname != name.nodename) {
+            facts.hostname = name.nodename;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Get the cgroup v2 mount: /sys/fs/cgroup on unified hosts, /sys/fs/cgroup/unified on
+// hybrid ones. Empty if there is no cgroup v2 hierarchy
+string getCgroupRoot() {
+    static const char* candidates[] = { "/sys/fs/cgroup", "/sys/fs/cgroup/unified" };
+    for (const char* root : candidates) {
+        if (access((string(root) + "/cgroup.controllers").c_str(), F_OK) == 0) return root;
+    }
+    return "";
+}
+
+// Parse a PSI file, see Documentation/accounting/psi.rst:
+//   some avg10=0.12 avg60=0.05 avg300=0.01 total=123456
+//   full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+// System-wide cpu has no `full` line before Linux 5.13, it is left at zero
+bool parsePressure(const char* buf, size_t len, PressureStats& stats) {
+    char text[256];
+    len = min(len, sizeof(text) - 1);
+    memcpy(text, buf, len);
+    text[len] = '\0';
+
+    PressureLine* lines[] = { &stats.some, &stats.full };
+    const char* names[] = { "some", "full" };
+    stats.valid = false;
+    for (int i = 0; i < 2; i++) {
+        PressureLine& line = *lines[i];
+        line = PressureLine();
+        const char* start = strstr(text, names[i]);
+        unsigned long long total = 0;
+        if (start && sscanf(start + 4, " avg10=%f avg60=%f avg300=%f total=%llu",
+                            &line.avg10, &line.avg60, &line.avg300, &total) == 4) {
+            line.total = total;
+            stats.valid = true;
+        }
+    }
+    return stats.valid;
+}
+
+static const char* pressureNames[PRESSURE_COUNT] = { "cpu", "memory", "io" };
+
+// Open the PSI file of one resource: /proc/pressure/<resource> system wide, or
+// <dir>/<resource>.pressure for a cgroup. Returns -1 if it doesn't exist
+int openPressureFile(const string& dir, PressureResource resource, bool perCgroup) {
+    string path = perCgroup ? dir + "/" + pressureNames[resource] + ".pressure"
+                            : dir + "/" + pressureNames[resource];
+    return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+// Re-read an open PSI file
+bool readPressure(int fd, PressureStats& stats) {
+    char buf[256];
+    ssize_t len = fd >= 0 ? pread(fd, buf, sizeof(buf), 0) : -1;
+    if (len <= 0) {
+        stats = PressureStats();
+        return false;
+    }
+    return parsePressure(buf, static_cast<size_t>(len), stats);
+}
+
+// Turn the change in the stall totals into the share of the interval spent stalled.
+// The kernel averages lag by up to 10 s, this follows every refresh
+void computePressureRates(PressureStats& now, const PressureStats& prev, double seconds) {
+    auto rate = [seconds](uint64_t total, uint64_t previous) {
+        if (seconds <= 0.0 || total < previous) return 0.0f;
+        return static_cast<float>(min(100.0, (total - previous) / (seconds * 1e6) * 100.0));
+    };
+    bool first = !prev.valid;
+    now.some.rate = first ? now.some.avg10 : rate(now.some.total, prev.some.total);
+    now.full.rate = first ? now.full.avg10 : rate(now.full.total, prev.full.total);
+}
+
+// Ask the kernel to report when tasks stall on `resource` for `stallUs` within any
+// `windowUs` window. The descriptor polls POLLPRI on each event. Returns -1 on kernels
+// without triggers; unprivileged users need a window that is a multiple of 2 s
+int openPressureTrigger(PressureResource resource, uint64_t stallUs, uint64_t windowUs) {
+    string path = string("/proc/pressure/") + pressureNames[resource];
+    int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    char trigger[64];
+    int len = snprintf(trigger, sizeof(trigger), "some %llu %llu",
+                       static_cast<unsigned long long>(stallUs), static_cast<unsigned long long>(windowUs));
+    if (write(fd, trigger, len + 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Get task statistics from the rows of a process scan, so the System window
+// and the Processes table always agree on the same generation
+TaskStats getProcessStats(const vector<Proc>& processes) {
+    TaskStats stats = {0, 0, 0, 0, 0, 0};
+    for (const auto& proc : processes) {
+        switch(proc.state) {
+            case 'R': stats.running++; break;
+            case 'S': 
+            case 'I': stats.sleeping++; break;  // 'I' is idle (sleeping)
+            case 'D': stats.uninterruptible++; break;
+            case 'Z': stats.zombie++; break;
+            case 'T': 
+            case 't': stats.traced++; break;    // 't' is traced
+            default: stats.sleeping++; break;   // Other states count as sleeping
+        }
+    }
+    stats.total = static_cast<int>(processes.size());
+    return stats;
 }
 
 // Get CPU type information
@@ -169,11 +324,26 @@ string getCPUType() {
     return "Unknown";
 }
 
+// Get the number of online logical CPUs
+int getCPUCount() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+// Seconds on the monotonic clock, for intervals that must not jump with the wall clock
+double monotonicSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
 // Initialize performance data
 void initPerformanceData(PerformanceData& data) {
-    data.values.resize(100, 0.0f);
+    data.values.reset(100);
+    data.historyLength = 100;
     data.isPaused = false;
     data.fps = 30;
+    data.lastTime = 0.0;
     data.yScale = 1.0f;
     data.currentValue = 0.0f;
 }
@@ -181,91 +351,252 @@ void initPerformanceData(PerformanceData& data) {
 // Update performance data
 void updatePerformanceData(PerformanceData& data, float newValue) {
     if (!data.isPaused) {
-        data.values.erase(data.values.begin());
-        data.values.push_back(newValue);
+        data.values.push(newValue);
         data.currentValue = newValue;
     }
 }
 
-// Get CPU usage percentage
-float getCPUUsage() {
-    static long long lastTotalUser = 0, lastTotalUserLow = 0, lastTotalSys = 0, lastTotalIdle = 0;
-    long long totalUser, totalUserLow, totalSys, totalIdle;
-    
-    ifstream statFile("/proc/stat");
-    if (statFile.is_open()) {
-        string line;
-        getline(statFile, line);
-        stringstream ss(line);
-        string cpu;
-        ss >> cpu >> totalUser >> totalUserLow >> totalSys >> totalIdle;
-        
-        if (lastTotalUser == 0) {
-            lastTotalUser = totalUser;
-            lastTotalUserLow = totalUserLow;
-            lastTotalSys = totalSys;
-            lastTotalIdle = totalIdle;
-            return 0.0f;
+// Add a timestamped sample from the sampler. The graph has one slot per 1/fps seconds,
+// so if samples went missing (the UI fell a full queue behind, or the sampler stalled)
+// the last value is held across the gap instead of squeezing the time axis
+void addPerformanceSample(PerformanceData& data, const MetricSample& sample) {
+    if (data.isPaused) {
+        // a resumed graph continues from where it stopped, without a gap
+        data.lastTime = 0.0;
+        return;
+    }
+    if (data.lastTime > 0.0 && !data.values.empty()) {
+        double period = 1.0 / data.fps;
+        long missing = lround((sample.time - data.lastTime) / period) - 1;
+        missing = min<long>(missing, data.historyLength);
+        float held = data.values.back();
+        for (long i = 0; i < missing; i++) data.values.push(held);
+    }
+    updatePerformanceData(data, sample.value);
+    data.lastTime = sample.time;
+}
+
+// Change how many samples the graph shows; growing keeps the history already collected
+void setPerformanceHistory(PerformanceData& data, int length) {
+    data.historyLength = max(2, min(length, PERFORMANCE_HISTORY_MAX));
+    if (data.values.capacity() < static_cast<size_t>(data.historyLength)) {
+        data.values.resize(data.historyLength);
+    }
+}
+
+// PlotLines getter over the newest historyLength samples, zero-padded on the left until
+// the history fills up. PlotLines only samples one value per pixel column, so a frame
+// costs the same however long the history is
+float getPerformanceValue(void* data, int index) {
+    const PerformanceData& perf = *static_cast<const PerformanceData*>(data);
+    int size = static_cast<int>(perf.values.size());
+    int shown = min(size, perf.historyLength);
+    int padding = perf.historyLength - shown;
+    if (index < padding) return 0.0f;
+    return perf.values[size - shown + index - padding];
+}
+
+// Parse the cpu lines at the top of /proc/stat: the aggregate `cpu` line into `total`
+// and every `cpuN` line into cores[N]. CPUs without a line are offline and left zeroed.
+// Older kernels print fewer columns, the missing ones read as 0
+bool parseCPUStats(const char* buf, size_t len, CPUStats& total, vector<CPUStats>& cores, vector<bool>& online) {
+    const char* end = buf + len;
+    const char* p = buf;
+    bool haveTotal = false;
+    fill(online.begin(), online.end(), false);
+
+    while (end - p > 3 && memcmp(p, "cpu", 3) == 0) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) break;  // cut off by the read buffer
+        p += 3;
+
+        CPUStats* stats = &total;
+        if (*p == ' ') {
+            haveTotal = true;
+        } else {
+            size_t id = static_cast<size_t>(parseStatField(p, lineEnd));
+            if (id >= cores.size()) {
+                cores.resize(id + 1, CPUStats());
+                online.resize(id + 1, false);
+            }
+            online[id] = true;
+            stats = &cores[id];
         }
-        
-        long long totalUserDiff = totalUser - lastTotalUser;
-        long long totalUserLowDiff = totalUserLow - lastTotalUserLow;
-        long long totalSysDiff = totalSys - lastTotalSys;
-        long long totalIdleDiff = totalIdle - lastTotalIdle;
-        
-        lastTotalUser = totalUser;
-        lastTotalUserLow = totalUserLow;
-        lastTotalSys = totalSys;
-        lastTotalIdle = totalIdle;
-        
-        long long total = totalUserDiff + totalUserLowDiff + totalSysDiff + totalIdleDiff;
-        return total == 0 ? 0.0f : 100.0f * (total - totalIdleDiff) / total;
+        stats->user = parseStatField(p, lineEnd);
+        stats->nice = parseStatField(p, lineEnd);
+        stats->system = parseStatField(p, lineEnd);
+        stats->idle = parseStatField(p, lineEnd);
+        stats->iowait = parseStatField(p, lineEnd);
+        stats->irq = parseStatField(p, lineEnd);
+        stats->softirq = parseStatField(p, lineEnd);
+        stats->steal = parseStatField(p, lineEnd);
+        stats->guest = parseStatField(p, lineEnd);
+        stats->guestNice = parseStatField(p, lineEnd);
+        p = lineEnd + 1;
+    }
+    for (size_t i = 0; i < cores.size(); i++) {
+        if (!online[i]) cores[i] = CPUStats();
     }
-    return 0.0f;
+    return haveTotal;
 }
 
-// Get fan speed
-int getFanSpeed() {
+// Read the cpu lines of /proc/stat through a descriptor kept open between calls.
+// They come first in the file, the buffer only grows if a machine has so many CPUs
+// that they don't fit before the `intr` line
+bool readCPUStats(CPUStats& total, vector<CPUStats>& cores, vector<bool>& online) {
+    static int fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    static vector<char> buf(16384);
+    if (fd < 0) return false;
+
+    ssize_t len;
+    while ((len = pread(fd, buf.data(), buf.size(), 0)) == static_cast<ssize_t>(buf.size()) &&
+           !memmem(buf.data(), len, "\nintr ", 6)) {
+        buf.resize(buf.size() * 2);
+    }
+    if (len <= 0) return false;
+    return parseCPUStats(buf.data(), static_cast<size_t>(len), total, cores, online);
+}
+
+// Split the time between two /proc/stat readings into percentages.
+// Counters are clamped so one going backwards (iowait can) never shows as negative
+void computeCPUBreakdown(const CPUStats& now, const CPUStats& prev, CPUBreakdown& out) {
+    auto delta = [](long long int a, long long int b) { return a > b ? static_cast<double>(a - b) : 0.0; };
+    double guest = delta(now.guest, prev.guest);
+    double guestNice = delta(now.guestNice, prev.guestNice);
+    double user = max(0.0, delta(now.user, prev.user) - guest);
+    double nice = max(0.0, delta(now.nice, prev.nice) - guestNice);
+    double system = delta(now.system, prev.system);
+    double idle = delta(now.idle, prev.idle);
+    double iowait = delta(now.iowait, prev.iowait);
+    double irq = delta(now.irq, prev.irq);
+    double softirq = delta(now.softirq, prev.softirq);
+    double steal = delta(now.steal, prev.steal);
+
+    double total = user + nice + system + idle + iowait + irq + softirq + steal + guest + guestNice;
+    double scale = total > 0.0 ? 100.0 / total : 0.0;
+    out.user = user * scale;
+    out.nice = nice * scale;
+    out.system = system * scale;
+    out.idle = idle * scale;
+    out.iowait = iowait * scale;
+    out.irq = irq * scale;
+    out.softirq = softirq * scale;
+    out.steal = steal * scale;
+    out.guest = guest * scale;
+    out.guestNice = guestNice * scale;
+    out.busy = total > 0.0 ? 100.0f - out.idle - out.iowait : 0.0f;
+}
+
+// Open one sysfs attribute of a sensor and add it to the registry
+static void addSensor(vector<Sensor>& sensors, SensorKind kind, const string& path, const string& label, float scale) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    Sensor sensor;
+    sensor.reading = { kind, label, 0.0f, false };
+    sensor.fd = fd;
+    sensor.scale = scale;
+    sensors.push_back(sensor);
+}
+
+// Read the first line of a small sysfs file, without the newline
+static string readSysfsLine(const string& path) {
+    ifstream file(path);
+    string line;
+    getline(file, line);
+    return line;
+}
+
+// Find every thermal zone and every hwmon temp*_input and fan*_input, once.
+// hwmon channels use their driver's label when it has one (e.g. "Package id 0")
+void discoverSensors(vector<Sensor>& sensors) {
+    closeSensors(sensors);
+
+    DIR* thermalDir = opendir("/sys/class/thermal");
+    if (thermalDir != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(thermalDir)) != nullptr) {
+            if (strncmp(entry->d_name, "thermal_zone", 12) != 0) continue;
+            string zone = "/sys/class/thermal/" + string(entry->d_name);
+            string type = readSysfsLine(zone + "/type");
+            addSensor(sensors, SENSOR_TEMPERATURE, zone + "/temp",
+                      (type.empty() ? "thermal" : type) + " (" + entry->d_name + ")", 0.001f);
+        }
+        closedir(thermalDir);
+    }
+
     DIR* hwmonDir = opendir("/sys/class/hwmon");
     if (hwmonDir != nullptr) {
         struct dirent* entry;
         while ((entry = readdir(hwmonDir)) != nullptr) {
-            if (isdigit(entry->d_name[0])) {
-                string fanPath = "/sys/class/hwmon/" + string(entry->d_name) + "/fan1_input";
-                ifstream fanFile(fanPath);
-                if (fanFile.is_open()) {
-                    int speed;
-                    fanFile >> speed;
-                    closedir(hwmonDir);
-                    return speed;
-                }
+            if (strncmp(entry->d_name, "hwmon", 5) != 0) continue;
+            string device = "/sys/class/hwmon/" + string(entry->d_name);
+            string name = readSysfsLine(device + "/name");
+            if (name.empty()) name = entry->d_name;
+
+            DIR* channelDir = opendir(device.c_str());
+            if (channelDir == nullptr) continue;
+            struct dirent* channel;
+            while ((channel = readdir(channelDir)) != nullptr) {
+                // temp1_input, fan2_input, ...
+                string file = channel->d_name;
+                size_t suffix = file.rfind("_input");
+                if (suffix == string::npos || suffix + 6 != file.size()) continue;
+                SensorKind kind;
+                if (file.compare(0, 4, "temp") == 0) kind = SENSOR_TEMPERATURE;
+                else if (file.compare(0, 3, "fan") == 0) kind = SENSOR_FAN;
+                else continue;
+
+                string prefix = file.substr(0, suffix);
+                string label = readSysfsLine(device + "/" + prefix + "_label");
+                addSensor(sensors, kind, device + "/" + file, name + ": " + (label.empty() ? prefix : label),
+                          kind == SENSOR_TEMPERATURE ? 0.001f : 1.0f);
             }
+            closedir(channelDir);
         }
         closedir(hwmonDir);
     }
-    return 0;
+
+    // readdir order is arbitrary, keep the list stable between runs
+    sort(sensors.begin(), sensors.end(), [](const Sensor& a, const Sensor& b) {
+        return a.reading.label < b.reading.label;
+    });
 }
 
-// Get CPU temperature
-float getCPUTemperature() {
-    DIR* thermalDir = opendir("/sys/class/thermal");
-    if (thermalDir != nullptr) {
-        struct dirent* entry;
-        while ((entry = readdir(thermalDir)) != nullptr) {
-            if (isdigit(entry->d_name[0])) {
-                string tempPath = "/sys/class/thermal/thermal_" + string(entry->d_name) + "/temp";
-                ifstream tempFile(tempPath);
-                if (tempFile.is_open()) {
-                    int temp;
-                    tempFile >> temp;
-                    closedir(thermalDir);
-                    return temp / 1000.0f;  // Convert millidegree to degree
-                }
-            }
+// Re-read every sensor of one kind through its open descriptor
+void readSensors(vector<Sensor>& sensors, SensorKind kind) {
+    for (Sensor& sensor : sensors) {
+        if (sensor.reading.kind != kind) continue;
+        char buf[32];
+        ssize_t len = pread(sensor.fd, buf, sizeof(buf) - 1, 0);
+        // a disconnected fan or a sleeping device fails the read, keep it listed
+        sensor.reading.valid = len > 0;
+        if (len > 0) {
+            buf[len] = '\0';
+            sensor.reading.value = strtol(buf, nullptr, 10) * sensor.scale;
+        }
+    }
+}
+
+// Close every descriptor and empty the registry
+void closeSensors(vector<Sensor>& sensors) {
+    for (Sensor& sensor : sensors) close(sensor.fd);
+    sensors.clear();
+}
+
+// Pick the sensor a graph shows by default: the CPU package temperature when a known
+// driver reports one, otherwise the first sensor of that kind. Returns -1 if there is none
+int choosePrimarySensor(const vector<Sensor>& sensors, SensorKind kind) {
+    static const char* cpuSensors[] = { "Package id", "Tctl", "Tdie", "x86_pkg_temp", "cpu_thermal", "cpu-thermal" };
+    int first = -1;
+    for (size_t i = 0; i < sensors.size(); i++) {
+        if (sensors[i].reading.kind != kind) continue;
+        if (first < 0) first = static_cast<int>(i);
+        if (kind != SENSOR_TEMPERATURE) break;
+        for (const char* name : cpuSensors) {
+            if (sensors[i].reading.label.find(name) != string::npos) return static_cast<int>(i);
         }
-        closedir(thermalDir);
     }
-    return 0.0f;
+    return first;
 }
 
 